@@ -705,6 +705,8 @@ fast_downward_plugin(
     SOURCES
         pdbs/canonical_pdbs
         pdbs/canonical_pdbs_heuristic
+        pdbs/canonical_spdbs
+        pdbs/canonical_spdbs_heuristic
         pdbs/dominance_pruning
         pdbs/incremental_canonical_pdbs
         pdbs/match_tree
@@ -722,9 +724,12 @@ fast_downward_plugin(
         pdbs/pattern_generator
         pdbs/pdb_heuristic
         pdbs/plugin_group
+        pdbs/saturated_spdbs_heuristic
         pdbs/symbolic_pattern_database
         pdbs/spdb
         pdbs/spdb_heuristic
+        pdbs/spdb_params
+        pdbs/spdb_transitions
         pdbs/symbolic_pdb_heuristic
         pdbs/types
         pdbs/validation
@@ -763,15 +768,18 @@ fast_downward_plugin(
     HELP "Plugin containing the base for symbolic search"
     SOURCES
         symbolic/sym_bucket
+        symbolic/flat_add
         symbolic/opt_order
         symbolic/sym_variables
         symbolic/sym_enums
         symbolic/sym_utils
         symbolic/sym_state_space_manager
         symbolic/transition_relation
+        symbolic/parallel_image
         symbolic/original_state_space
         symbolic/sym_params_search
         symbolic/sym_estimate
+        symbolic/sym_checkpoint
         symbolic/frontier
         symbolic/open_list
         symbolic/closed_list
@@ -783,9 +791,12 @@ fast_downward_plugin(
         symbolic/search_engines/symbolic_uniform_cost_search
         symbolic/search_engines/top_k_symbolic_uniform_cost_search
         symbolic/search_engines/top_q_symbolic_uniform_cost_search
+        symbolic/search_engines/plan_counting_symbolic_search
         symbolic/plan_reconstruction/sym_solution_cut
         symbolic/plan_reconstruction/sym_solution_registry
+        symbolic/plan_reconstruction/plan_counter
         symbolic/plan_selection/plan_database
+        symbolic/plan_selection/plan_trie
         symbolic/plan_selection/top_k_selector
         symbolic/plan_selection/top_k_even_selector
         symbolic/plan_selection/moral_permissibility_selector
@@ -4,6 +4,7 @@
 #include "evaluation_result.h"
 
 #include <set>
+#include <vector>
 
 class EvaluationContext;
 class GlobalState;
@@ -53,6 +54,26 @@ public:
         const GlobalState & /*state*/) {
     }
 
+    /*
+      get_batch_evaluators should insert all evaluators that this
+      evaluator directly or indirectly depends on and that can evaluate
+      many states at once into the result set. The default
+      implementation inserts nothing.
+
+      compute_batch will be called for these and only these evaluators.
+      It receives the new successors of an expanded state before they
+      are evaluated one by one, so that the following compute_result
+      calls can be served from values computed together.
+      calculate_preferred is the flag of the evaluation contexts of these
+      calls.
+    */
+    virtual void get_batch_evaluators(std::set<Evaluator *> & /*evals*/) {
+    }
+
+    virtual void compute_batch(const std::vector<GlobalState> & /*states*/,
+                               bool /*calculate_preferred*/) {
+    }
+
     /*
       compute_result should compute the estimate and possibly
       preferred operators for the given evaluation context and return
@@ -50,4 +50,9 @@ void CombiningEvaluator::get_path_dependent_evaluators(
     for (auto &subevaluator : subevaluators)
         subevaluator->get_path_dependent_evaluators(evals);
 }
+
+void CombiningEvaluator::get_batch_evaluators(set<Evaluator *> &evals) {
+    for (auto &subevaluator : subevaluators)
+        subevaluator->get_batch_evaluators(evals);
+}
 }
@@ -58,7 +58,14 @@ EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
         heuristic = heuristic_cache[state].h;
         result.set_count_evaluation(false);
     } else {
-        heuristic = compute_heuristic(state);
+        auto it = calculate_preferred ? batch_values.end() :
+            batch_values.find(state.get_id().get_value());
+        if (it != batch_values.end()) {
+            heuristic = it->second;
+            batch_values.erase(it);
+        } else {
+            heuristic = compute_heuristic(state);
+        }
         if (cache_evaluator_values) {
             heuristic_cache[state] = HEntry(heuristic, false);
         }
@@ -96,6 +103,42 @@ EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
     return result;
 }
 
+void Heuristic::compute_heuristic_batch(
+    const vector<GlobalState> &states, vector<int> &values) {
+    values.clear();
+    values.reserve(states.size());
+    for (const GlobalState &state : states) {
+        values.push_back(compute_heuristic(state));
+    }
+}
+
+void Heuristic::compute_batch(
+    const vector<GlobalState> &states, bool calculate_preferred) {
+    batch_values.clear();
+    /*
+      compute_result calls compute_heuristic anyway to collect the
+      preferred operators of the states.
+    */
+    if (calculate_preferred)
+        return;
+    vector<GlobalState> uncached_states;
+    uncached_states.reserve(states.size());
+    for (const GlobalState &state : states) {
+        if (!cache_evaluator_values || heuristic_cache[state].h == NO_VALUE ||
+            heuristic_cache[state].dirty) {
+            uncached_states.push_back(state);
+        }
+    }
+    if (uncached_states.empty())
+        return;
+    vector<int> values;
+    compute_heuristic_batch(uncached_states, values);
+    assert(values.size() == uncached_states.size());
+    for (size_t i = 0; i < uncached_states.size(); ++i) {
+        batch_values[uncached_states[i].get_id().get_value()] = values[i];
+    }
+}
+
 bool Heuristic::does_cache_estimates() const {
     return cache_evaluator_values;
 }
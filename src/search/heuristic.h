@@ -9,6 +9,7 @@
 #include "algorithms/ordered_set.h"
 
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 class TaskProxy;
@@ -44,6 +45,12 @@ class Heuristic : public Evaluator {
     */
     ordered_set::OrderedSet<OperatorID> preferred_operators;
 
+    /*
+      Values computed by compute_batch that compute_result has not
+      used yet, indexed by the value of the state ID.
+    */
+    std::unordered_map<int, int> batch_values;
+
 protected:
     /*
       Cache for saving h values
@@ -64,6 +71,15 @@ protected:
     // TODO: Call with State directly once all heuristics support it.
     virtual int compute_heuristic(const GlobalState &state) = 0;
 
+    /*
+      Computes the heuristic values of all given states. The default
+      implementation calls compute_heuristic for each of them;
+      heuristics that can share work between states should override it
+      and insert themselves in get_batch_evaluators.
+    */
+    virtual void compute_heuristic_batch(
+        const std::vector<GlobalState> &states, std::vector<int> &values);
+
     /*
       Usage note: Marking the same operator as preferred multiple times
       is OK -- it will only appear once in the list of preferred
@@ -88,6 +104,10 @@ public:
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) override;
 
+    virtual void compute_batch(
+        const std::vector<GlobalState> &states,
+        bool calculate_preferred) override;
+
     virtual bool does_cache_estimates() const override;
     virtual bool is_estimate_cached(const GlobalState &state) const override;
     virtual int get_cached_estimate(const GlobalState &state) const override;
@@ -91,6 +91,12 @@ public:
     virtual void get_path_dependent_evaluators(
         std::set<Evaluator *> &evals) = 0;
 
+    /*
+      Add all evaluators that this open list uses (directly or indirectly)
+      and that support batch evaluation into the result set.
+    */
+    virtual void get_batch_evaluators(std::set<Evaluator *> &evals) = 0;
+
     /*
       Accessor method for only_preferred.
 
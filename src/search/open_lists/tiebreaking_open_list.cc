@@ -45,6 +45,7 @@ public:
     virtual bool empty() const override;
     virtual void clear() override;
     virtual void get_path_dependent_evaluators(set<Evaluator *> &evals) override;
+    virtual void get_batch_evaluators(set<Evaluator *> &evals) override;
     virtual bool is_dead_end(
         EvaluationContext &eval_context) const override;
     virtual bool is_reliable_dead_end(
@@ -109,6 +110,13 @@ void TieBreakingOpenList<Entry>::get_path_dependent_evaluators(
         evaluator->get_path_dependent_evaluators(evals);
 }
 
+template<class Entry>
+void TieBreakingOpenList<Entry>::get_batch_evaluators(
+    set<Evaluator *> &evals) {
+    for (const shared_ptr<Evaluator> &evaluator : evaluators)
+        evaluator->get_batch_evaluators(evals);
+}
+
 template<class Entry>
 bool TieBreakingOpenList<Entry>::is_dead_end(
     EvaluationContext &eval_context) const {
@@ -44,6 +44,7 @@ public:
     virtual bool is_reliable_dead_end(
         EvaluationContext &eval_context) const override;
     virtual void get_path_dependent_evaluators(set<Evaluator *> &evals) override;
+    virtual void get_batch_evaluators(set<Evaluator *> &evals) override;
 };
 
 template<class Entry>
@@ -135,6 +136,14 @@ void TypeBasedOpenList<Entry>::get_path_dependent_evaluators(
     }
 }
 
+template<class Entry>
+void TypeBasedOpenList<Entry>::get_batch_evaluators(
+    set<Evaluator *> &evals) {
+    for (const shared_ptr<Evaluator> &evaluator : evaluators) {
+        evaluator->get_batch_evaluators(evals);
+    }
+}
+
 TypeBasedOpenListFactory::TypeBasedOpenListFactory(
     const Options &options)
     : options(options) {
@@ -0,0 +1,60 @@
+#include "canonical_spdbs.h"
+
+#include "spdb.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <unordered_map>
+
+using namespace std;
+
+namespace pdbs {
+CanonicalSPDBs::CanonicalSPDBs(
+    const shared_ptr<MaxAdditiveSPDBSubsets> &max_additive_subsets_)
+    : max_additive_subsets(max_additive_subsets_) {
+    assert(max_additive_subsets);
+}
+
+int CanonicalSPDBs::get_value(const State &state) const {
+    // If we have an empty collection, then max_additive_subsets = { \emptyset }.
+    assert(!max_additive_subsets->empty());
+    int max_h = 0;
+    for (const auto &subset : *max_additive_subsets) {
+        int subset_h = 0;
+        for (const shared_ptr<SPDB> &spdb : subset) {
+            int h = spdb->get_value(state);
+            if (h == numeric_limits<int>::max())
+                return numeric_limits<int>::max();
+            subset_h += h;
+        }
+        max_h = max(max_h, subset_h);
+    }
+    return max_h;
+}
+
+void CanonicalSPDBs::get_values(
+    const vector<State> &states, vector<int> &values) const {
+    const int infinity = numeric_limits<int>::max();
+    // SPDBs may occur in several subsets, so cache their values.
+    unordered_map<const SPDB *, vector<int>> spdb_values;
+    values.assign(states.size(), 0);
+    vector<int> subset_h;
+    for (const auto &subset : *max_additive_subsets) {
+        subset_h.assign(states.size(), 0);
+        for (const shared_ptr<SPDB> &spdb : subset) {
+            vector<int> &h_values = spdb_values[spdb.get()];
+            if (h_values.empty())
+                spdb->get_values(states, h_values);
+            for (size_t i = 0; i < states.size(); ++i) {
+                if (h_values[i] == infinity || subset_h[i] == infinity)
+                    subset_h[i] = infinity;
+                else
+                    subset_h[i] += h_values[i];
+            }
+        }
+        for (size_t i = 0; i < states.size(); ++i)
+            values[i] = max(values[i], subset_h[i]);
+    }
+}
+}
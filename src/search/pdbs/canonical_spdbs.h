@@ -0,0 +1,32 @@
+#ifndef PDBS_CANONICAL_SPDBS_H
+#define PDBS_CANONICAL_SPDBS_H
+
+#include "types.h"
+
+#include <memory>
+#include <vector>
+
+class State;
+
+namespace pdbs {
+/*
+  Canonical heuristic over a collection of symbolic PDBs: the maximum over
+  all maximal additive subsets of the sum of the SPDB values in the subset.
+*/
+class CanonicalSPDBs {
+    std::shared_ptr<MaxAdditiveSPDBSubsets> max_additive_subsets;
+
+public:
+    explicit CanonicalSPDBs(
+        const std::shared_ptr<MaxAdditiveSPDBSubsets> &max_additive_subsets);
+    ~CanonicalSPDBs() = default;
+
+    int get_value(const State &state) const;
+
+    // Computes the values of many states, evaluating each SPDB only once.
+    void get_values(const std::vector<State> &states,
+                    std::vector<int> &values) const;
+};
+}
+
+#endif
@@ -0,0 +1,205 @@
+#include "canonical_spdbs_heuristic.h"
+
+#include "max_additive_pdb_sets.h"
+#include "pattern_generator.h"
+#include "spdb.h"
+#include "spdb_heuristic.h"
+
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../symbolic/sym_variables.h"
+#include "../utils/timer.h"
+
+#include <atomic>
+#include <exception>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+using namespace std;
+
+namespace pdbs {
+/*
+  CUDD managers are not thread-safe, so every thread builds its SPDBs with
+  its own SymVariables (or one per SPDB with pattern_var_order). The SPDBs
+  are flattened, which releases all BDDs, and the manager of a thread is
+  destroyed once it is done.
+
+  The output of each SPDB is buffered and printed in pattern order after
+  all threads are joined. An exception in a thread stops the remaining
+  work and is rethrown in the calling thread.
+*/
+static SPDBCollection build_spdbs_in_parallel(
+    const TaskProxy &task_proxy, const PatternCollection &patterns,
+    const Options &opts, const SPDBParams &params, int num_threads) {
+    num_threads = min<int>(num_threads, patterns.size());
+    bool pattern_var_order = opts.get<bool>("pattern_var_order");
+    vector<shared_ptr<symbolic::SymVariables>> thread_vars(num_threads);
+    if (pattern_var_order) {
+        // The causal graph is cached on first use, which is not thread-safe.
+        TaskProxy(*tasks::g_root_task).get_causal_graph();
+    } else {
+        // All shared managers use the same variable order.
+        vector<int> var_order =
+            symbolic::SymVariables(opts).compute_var_order();
+        for (auto &vars : thread_vars) {
+            vars = make_shared<symbolic::SymVariables>(opts);
+            vars->split_memory(num_threads);
+            vars->init(var_order);
+        }
+    }
+    SPDBCollection spdbs(patterns.size());
+    vector<ostringstream> logs(patterns.size());
+    atomic<size_t> next_pattern(0);
+    mutex error_mutex;
+    exception_ptr error;
+    auto build_spdbs = [&](shared_ptr<symbolic::SymVariables> vars) {
+        try {
+            for (size_t i = next_pattern++; i < patterns.size();
+                 i = next_pattern++) {
+                SPDBParams spdb_params(params);
+                spdb_params.log = &logs[i];
+                auto spdb = make_shared<SPDB>(
+                    get_spdb_sym_variables(opts, patterns[i], vars,
+                                           num_threads, logs[i]),
+                    task_proxy, patterns[i], false, vector<int>(),
+                    spdb_params);
+                spdb->flatten(logs[i]);
+                spdbs[i] = spdb;
+            }
+        } catch (...) {
+            next_pattern = patterns.size();
+            lock_guard<mutex> lock(error_mutex);
+            if (!error)
+                error = current_exception();
+        }
+    };
+    vector<thread> threads;
+    for (int i = 0; i < num_threads; ++i)
+        threads.emplace_back(build_spdbs, move(thread_vars[i]));
+    for (thread &t : threads)
+        t.join();
+    for (const ostringstream &log : logs)
+        cout << log.str();
+    if (error) {
+        // Show the output of the finished SPDBs if the exception aborts.
+        cout << flush;
+        rethrow_exception(error);
+    }
+    return spdbs;
+}
+
+CanonicalSPDBs get_canonical_spdbs_from_options(
+    const shared_ptr<AbstractTask> &task, const Options &opts) {
+    shared_ptr<PatternCollectionGenerator> pattern_generator =
+        opts.get<shared_ptr<PatternCollectionGenerator>>("patterns");
+    utils::Timer timer;
+    PatternCollectionInformation pattern_collection_info =
+        pattern_generator->generate(task);
+    shared_ptr<PatternCollection> patterns =
+        pattern_collection_info.get_patterns();
+    TaskProxy task_proxy(*task);
+
+    SPDBParams params(opts);
+    SPDBCollection spdbs;
+    int num_threads = opts.get<int>("num_threads");
+    if (num_threads > 1) {
+        spdbs = build_spdbs_in_parallel(
+            task_proxy, *patterns, opts, params, num_threads);
+    } else {
+        spdbs.reserve(patterns->size());
+        for (const Pattern &pattern : *patterns) {
+            spdbs.push_back(make_shared<SPDB>(
+                                get_spdb_sym_variables(opts, pattern),
+                                task_proxy, pattern, false,
+                                vector<int>(), params));
+            if (opts.get<bool>("flatten"))
+                spdbs.back()->flatten();
+        }
+    }
+    cout << "SPDB collection construction time: " << timer << endl;
+
+    shared_ptr<MaxAdditiveSPDBSubsets> max_additive_subsets =
+        compute_max_additive_subsets(spdbs, compute_additive_vars(task_proxy));
+    cout << "Number of SPDBs: " << spdbs.size() << endl;
+    cout << "Number of additive subsets: " << max_additive_subsets->size()
+         << endl;
+    return CanonicalSPDBs(max_additive_subsets);
+}
+
+CanonicalSPDBsHeuristic::CanonicalSPDBsHeuristic(const Options &opts)
+    : Heuristic(opts),
+      canonical_spdbs(get_canonical_spdbs_from_options(task, opts)) {
+}
+
+int CanonicalSPDBsHeuristic::compute_heuristic(const GlobalState &global_state) {
+    State state = convert_global_state(global_state);
+    return compute_heuristic(state);
+}
+
+int CanonicalSPDBsHeuristic::compute_heuristic(const State &state) const {
+    int h = canonical_spdbs.get_value(state);
+    if (h == numeric_limits<int>::max()) {
+        return DEAD_END;
+    } else {
+        return h;
+    }
+}
+
+void CanonicalSPDBsHeuristic::compute_heuristic_batch(
+    const vector<GlobalState> &global_states, vector<int> &values) {
+    vector<State> states;
+    states.reserve(global_states.size());
+    for (const GlobalState &global_state : global_states)
+        states.push_back(convert_global_state(global_state));
+    canonical_spdbs.get_values(states, values);
+    for (int &h : values) {
+        if (h == numeric_limits<int>::max())
+            h = DEAD_END;
+    }
+}
+
+static shared_ptr<Heuristic> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Canonical symbolic PDBs",
+        "Builds one symbolic PDB per pattern of the given collection. All "
+        "SPDBs share one CUDD manager. The heuristic value is the maximum "
+        "over all maximal additive subsets of the collection, where the "
+        "value for one subset is the sum of the values of its SPDBs. Since "
+        "SPDBs are represented as ADDs, the number of abstract states is "
+        "not bounded by the size of an explicit table.");
+    parser.document_language_support("action costs", "supported");
+    parser.document_language_support("conditional effects", "not supported");
+    parser.document_language_support("axioms", "not supported");
+    parser.document_property("admissible", "yes");
+    parser.document_property("consistent", "yes");
+    parser.document_property("safe", "yes");
+    parser.document_property("preferred operators", "no");
+
+    parser.add_option<shared_ptr<PatternCollectionGenerator>>(
+        "patterns",
+        "pattern generation method",
+        "systematic(1)");
+    parser.add_option<int>(
+        "num_threads",
+        "number of threads that build the SPDBs. With more than one thread, "
+        "every thread uses its own CUDD manager with an equal share of the "
+        "memory, and all SPDBs are flattened",
+        "1",
+        Bounds("1", "infinity"));
+    add_spdb_options_to_parser(parser);
+    Heuristic::add_options_to_parser(parser);
+
+    Options opts = parser.parse();
+    if (parser.dry_run())
+        return nullptr;
+
+    return make_shared<CanonicalSPDBsHeuristic>(opts);
+}
+
+static Plugin<Evaluator> _plugin("canonical_spdbs", _parse, "heuristics_pdb");
+}
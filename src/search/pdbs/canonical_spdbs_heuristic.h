@@ -0,0 +1,30 @@
+#ifndef PDBS_CANONICAL_SPDBS_HEURISTIC_H
+#define PDBS_CANONICAL_SPDBS_HEURISTIC_H
+
+#include "canonical_spdbs.h"
+
+#include "../heuristic.h"
+
+namespace pdbs {
+// Implements the canonical heuristic function over symbolic PDBs.
+class CanonicalSPDBsHeuristic : public Heuristic {
+    CanonicalSPDBs canonical_spdbs;
+
+protected:
+    virtual int compute_heuristic(const GlobalState &global_state) override;
+    int compute_heuristic(const State &state) const;
+    virtual void compute_heuristic_batch(
+        const std::vector<GlobalState> &states,
+        std::vector<int> &values) override;
+
+public:
+    explicit CanonicalSPDBsHeuristic(const options::Options &opts);
+    virtual ~CanonicalSPDBsHeuristic() = default;
+
+    virtual void get_batch_evaluators(std::set<Evaluator *> &evals) override {
+        evals.insert(this);
+    }
+};
+}
+
+#endif
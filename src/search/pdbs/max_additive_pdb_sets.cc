@@ -1,6 +1,7 @@
 #include "max_additive_pdb_sets.h"
 
 #include "pattern_database.h"
+#include "spdb.h"
 
 #include "../task_proxy.h"
 
@@ -38,8 +39,9 @@ VariableAdditivity compute_additive_vars(const TaskProxy &task_proxy) {
     return are_additive;
 }
 
-shared_ptr<MaxAdditivePDBSubsets> compute_max_additive_subsets(
-    const PDBCollection &pdbs, const VariableAdditivity &are_additive) {
+template<typename DB>
+static shared_ptr<vector<vector<shared_ptr<DB>>>> compute_max_additive_db_subsets(
+    const vector<shared_ptr<DB>> &pdbs, const VariableAdditivity &are_additive) {
     // Initialize compatibility graph.
     vector<vector<int>> cgraph;
     cgraph.resize(pdbs.size());
@@ -60,11 +62,10 @@ shared_ptr<MaxAdditivePDBSubsets> compute_max_additive_subsets(
     vector<vector<int>> max_cliques;
     max_cliques::compute_max_cliques(cgraph, max_cliques);
 
-    shared_ptr<MaxAdditivePDBSubsets> max_additive_sets =
-        make_shared<MaxAdditivePDBSubsets>();
+    auto max_additive_sets = make_shared<vector<vector<shared_ptr<DB>>>>();
     max_additive_sets->reserve(max_cliques.size());
     for (const vector<int> &max_clique : max_cliques) {
-        PDBCollection max_additive_subset;
+        vector<shared_ptr<DB>> max_additive_subset;
         max_additive_subset.reserve(max_clique.size());
         for (int pdb_id : max_clique) {
             max_additive_subset.push_back(pdbs[pdb_id]);
@@ -74,6 +75,16 @@ shared_ptr<MaxAdditivePDBSubsets> compute_max_additive_subsets(
     return max_additive_sets;
 }
 
+shared_ptr<MaxAdditivePDBSubsets> compute_max_additive_subsets(
+    const PDBCollection &pdbs, const VariableAdditivity &are_additive) {
+    return compute_max_additive_db_subsets(pdbs, are_additive);
+}
+
+shared_ptr<MaxAdditiveSPDBSubsets> compute_max_additive_subsets(
+    const SPDBCollection &spdbs, const VariableAdditivity &are_additive) {
+    return compute_max_additive_db_subsets(spdbs, are_additive);
+}
+
 MaxAdditivePDBSubsets compute_max_additive_subsets_with_pattern(
     const MaxAdditivePDBSubsets &known_additive_subsets,
     const Pattern &new_pattern,
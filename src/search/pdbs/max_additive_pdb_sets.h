@@ -25,6 +25,10 @@ extern bool are_patterns_additive(const Pattern &pattern1,
 extern std::shared_ptr<MaxAdditivePDBSubsets> compute_max_additive_subsets(
     const PDBCollection &pdbs, const VariableAdditivity &are_additive);
 
+// Same as above for symbolic PDBs.
+extern std::shared_ptr<MaxAdditiveSPDBSubsets> compute_max_additive_subsets(
+    const SPDBCollection &spdbs, const VariableAdditivity &are_additive);
+
 /*
   We compute additive pattern sets S with the property that we could
   add the new pattern P to S and still have an additive pattern set.
@@ -0,0 +1,112 @@
+#include "saturated_spdbs_heuristic.h"
+
+#include "pattern_generator.h"
+#include "spdb.h"
+#include "spdb_heuristic.h"
+
+#include "../option_parser.h"
+#include "../plugin.h"
+
+#include "../symbolic/sym_variables.h"
+#include "../task_utils/task_properties.h"
+#include "../utils/timer.h"
+
+#include <cassert>
+#include <iostream>
+#include <limits>
+#include <memory>
+
+using namespace std;
+
+namespace pdbs {
+static void reduce_remaining_costs(
+    vector<int> &remaining_costs, const vector<int> &saturated_costs) {
+    assert(remaining_costs.size() == saturated_costs.size());
+    for (size_t i = 0; i < remaining_costs.size(); ++i) {
+        assert(0 <= saturated_costs[i] &&
+               saturated_costs[i] <= remaining_costs[i]);
+        remaining_costs[i] -= saturated_costs[i];
+    }
+}
+
+static SPDBCollection compute_saturated_spdbs(
+    const shared_ptr<AbstractTask> &task, const Options &opts) {
+    shared_ptr<PatternCollectionGenerator> pattern_generator =
+        opts.get<shared_ptr<PatternCollectionGenerator>>("patterns");
+    utils::Timer timer;
+    shared_ptr<PatternCollection> patterns =
+        pattern_generator->generate(task).get_patterns();
+    TaskProxy task_proxy(*task);
+
+    SPDBParams params(opts);
+    vector<int> remaining_costs = task_properties::get_operator_costs(task_proxy);
+    SPDBCollection spdbs;
+    for (const Pattern &pattern : *patterns) {
+        auto spdb = make_shared<SPDB>(
+            get_spdb_sym_variables(opts, pattern), task_proxy, pattern,
+            false, remaining_costs, params);
+        reduce_remaining_costs(
+            remaining_costs,
+            spdb->compute_saturated_costs(task_proxy, remaining_costs));
+        if (opts.get<bool>("flatten"))
+            spdb->flatten();
+        spdbs.push_back(spdb);
+    }
+    cout << "Saturated SPDBs construction time: " << timer << endl;
+    cout << "Number of SPDBs: " << spdbs.size() << endl;
+    return spdbs;
+}
+
+SaturatedSPDBsHeuristic::SaturatedSPDBsHeuristic(const Options &opts)
+    : Heuristic(opts),
+      spdbs(compute_saturated_spdbs(task, opts)) {
+}
+
+int SaturatedSPDBsHeuristic::compute_heuristic(const GlobalState &global_state) {
+    State state = convert_global_state(global_state);
+    return compute_heuristic(state);
+}
+
+int SaturatedSPDBsHeuristic::compute_heuristic(const State &state) const {
+    int sum_h = 0;
+    for (const shared_ptr<SPDB> &spdb : spdbs) {
+        int h = spdb->get_value(state);
+        if (h == numeric_limits<int>::max())
+            return DEAD_END;
+        sum_h += h;
+    }
+    return sum_h;
+}
+
+static shared_ptr<Heuristic> _parse(OptionParser &parser) {
+    parser.document_synopsis(
+        "Saturated cost partitioning over symbolic PDBs",
+        "Builds one symbolic PDB per pattern of the given collection, in "
+        "the order of the collection. After building an SPDB, the "
+        "saturated costs of all operators are computed from its layers "
+        "and subtracted from the remaining costs, which the next SPDB is "
+        "built for. The heuristic value is the sum of all SPDB values.");
+    parser.document_language_support("action costs", "supported");
+    parser.document_language_support("conditional effects", "not supported");
+    parser.document_language_support("axioms", "not supported");
+    parser.document_property("admissible", "yes");
+    parser.document_property("consistent", "yes");
+    parser.document_property("safe", "yes");
+    parser.document_property("preferred operators", "no");
+
+    parser.add_option<shared_ptr<PatternCollectionGenerator>>(
+        "patterns",
+        "pattern generation method",
+        "systematic(1)");
+    add_spdb_options_to_parser(parser);
+    Heuristic::add_options_to_parser(parser);
+
+    Options opts = parser.parse();
+    if (parser.dry_run())
+        return nullptr;
+
+    return make_shared<SaturatedSPDBsHeuristic>(opts);
+}
+
+static Plugin<Evaluator> _plugin("saturated_spdbs", _parse, "heuristics_pdb");
+}
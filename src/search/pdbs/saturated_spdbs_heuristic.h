@@ -0,0 +1,28 @@
+#ifndef PDBS_SATURATED_SPDBS_HEURISTIC_H
+#define PDBS_SATURATED_SPDBS_HEURISTIC_H
+
+#include "types.h"
+
+#include "../heuristic.h"
+
+namespace pdbs {
+/*
+  Saturated cost partitioning over a sequence of symbolic PDBs. Each SPDB
+  is built for the costs that the previous SPDBs did not need, so the sum
+  of all SPDB values is admissible.
+*/
+class SaturatedSPDBsHeuristic : public Heuristic {
+    SPDBCollection spdbs;
+
+    int compute_heuristic(const State &state) const;
+
+protected:
+    virtual int compute_heuristic(const GlobalState &global_state) override;
+
+public:
+    explicit SaturatedSPDBsHeuristic(const options::Options &opts);
+    virtual ~SaturatedSPDBsHeuristic() override = default;
+};
+}
+
+#endif
@@ -1,5 +1,7 @@
 #include "spdb.h"
 
+#include "spdb_transitions.h"
+
 #include "../symbolic/transition_relation.h"
 
 #include "match_tree.h"
@@ -7,6 +9,7 @@
 #include "../algorithms/priority_queues.h"
 #include "../task_utils/task_properties.h"
 #include "../utils/collections.h"
+#include "../utils/hash.h"
 #include "../utils/logging.h"
 #include "../utils/math.h"
 #include "../utils/timer.h"
@@ -14,8 +17,10 @@
 #include <algorithm>
 #include <cassert>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
 #include <limits>
+#include <numeric>
 #include <string>
 #include <vector>
 
@@ -23,10 +28,49 @@ using namespace std;
 using namespace symbolic;
 
 namespace pdbs {
+static const char SPDB_FILE_MAGIC[4] = {'S', 'P', 'D', 'B'};
+static const int SPDB_FILE_VERSION = 1;
+
+/*
+  Everything except the initial state determines the SPDB, so files can be
+  reused for all tasks that only differ in their initial state.
+*/
+static uint64_t compute_fingerprint(const TaskProxy &task_proxy,
+                                    const Pattern &pattern,
+                                    const vector<int> &operator_costs) {
+  utils::HashState hash_state;
+  utils::feed(hash_state, pattern);
+  for (VariableProxy var : task_proxy.get_variables()) {
+    utils::feed(hash_state, var.get_domain_size());
+  }
+  for (OperatorProxy op : task_proxy.get_operators()) {
+    utils::feed(hash_state, static_cast<int>(op.get_preconditions().size()));
+    for (FactProxy pre : op.get_preconditions()) {
+      utils::feed(hash_state, pre.get_pair());
+    }
+    utils::feed(hash_state, static_cast<int>(op.get_effects().size()));
+    for (EffectProxy eff : op.get_effects()) {
+      utils::feed(hash_state, eff.get_fact().get_pair());
+    }
+    utils::feed(hash_state, operator_costs.empty()
+                                ? op.get_cost()
+                                : operator_costs[op.get_id()]);
+  }
+  for (FactProxy goal : task_proxy.get_goals()) {
+    utils::feed(hash_state, goal.get_pair());
+  }
+  return hash_state.get_hash64();
+}
+
+static void exit_with_file_error(const string &file_name,
+                                 const string &message) {
+  cerr << "Could not load SPDB from " << file_name << ": " << message << endl;
+  utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+}
 
-SPDB::SPDB(SymVariables *sVars, const TaskProxy &task_proxy,
+SPDB::SPDB(const shared_ptr<SymVariables> &sVars, const TaskProxy &task_proxy,
            const Pattern &pattern, bool dump,
-           const vector<int> &operator_costs)
+           const vector<int> &operator_costs, const SPDBParams &params)
 :sV(sVars), pattern(pattern) {
   task_properties::verify_no_axioms(task_proxy);
   task_properties::verify_no_conditional_effects(task_proxy);
@@ -34,46 +78,96 @@ SPDB::SPDB(SymVariables *sVars, const TaskProxy &task_proxy,
          operator_costs.size() == task_proxy.get_operators().size());
   assert(utils::is_sorted_unique(pattern));
   utils::Timer timer;
-  create_spdb(task_proxy, operator_costs);
-  if (dump)
-    cout << "SPDB construction time: " << timer << endl;
+  fingerprint = compute_fingerprint(task_proxy, pattern, operator_costs);
+  create_spdb(task_proxy, operator_costs, params);
+  if (dump) {
+    *params.log << "SPDB construction time: " << timer << endl;
+    *params.log << "SPDB layers: " << closedList.size()
+                << ", heuristic ADD nodes: " << heuristic.nodeCount() << endl;
+    sV->print_statistics();
+  }
+}
+
+SPDB::SPDB(const TaskProxy &task_proxy, const string &file_name,
+           const vector<int> &operator_costs)
+    : initialHVal(numeric_limits<int>::max()) {
+  ifstream file(file_name, ios::binary);
+  if (!file) {
+    exit_with_file_error(file_name, "cannot open file");
+  }
+  char magic[4];
+  int version = 0;
+  file.read(magic, sizeof(magic));
+  file.read(reinterpret_cast<char *>(&version), sizeof(version));
+  if (!file || !equal(magic, magic + 4, SPDB_FILE_MAGIC) ||
+      version != SPDB_FILE_VERSION) {
+    exit_with_file_error(file_name, "not an SPDB file of this version");
+  }
+  int num_variables = task_proxy.get_variables().size();
+  int pattern_size = 0;
+  file.read(reinterpret_cast<char *>(&fingerprint), sizeof(fingerprint));
+  file.read(reinterpret_cast<char *>(&pattern_size), sizeof(pattern_size));
+  if (!file || pattern_size < 0 || pattern_size > num_variables) {
+    exit_with_file_error(file_name, "corrupt header");
+  }
+  pattern.resize(pattern_size);
+  file.read(reinterpret_cast<char *>(pattern.data()),
+            pattern_size * sizeof(int));
+  if (!file) {
+    exit_with_file_error(file_name, "file ends prematurely");
+  }
+  for (int var : pattern) {
+    if (var < 0 || var >= num_variables) {
+      exit_with_file_error(file_name, "corrupt pattern");
+    }
+  }
+  if (!flat_heuristic.read(file, num_variables)) {
+    exit_with_file_error(file_name, "corrupt or incomplete heuristic table");
+  }
+  if (fingerprint !=
+      compute_fingerprint(task_proxy, pattern, operator_costs)) {
+    exit_with_file_error(file_name, "the SPDB was built for another task");
+  }
+  initialHVal =
+      flat_heuristic.get_value(task_proxy.get_initial_state().get_values());
+  cout << "Loaded SPDB for pattern " << pattern << " from " << file_name
+       << endl;
+}
+
+void SPDB::save(const string &file_name) const {
+  ofstream file(file_name, ios::binary);
+  file.write(SPDB_FILE_MAGIC, sizeof(SPDB_FILE_MAGIC));
+  file.write(reinterpret_cast<const char *>(&SPDB_FILE_VERSION),
+             sizeof(SPDB_FILE_VERSION));
+  file.write(reinterpret_cast<const char *>(&fingerprint), sizeof(fingerprint));
+  int pattern_size = pattern.size();
+  file.write(reinterpret_cast<const char *>(&pattern_size),
+             sizeof(pattern_size));
+  file.write(reinterpret_cast<const char *>(pattern.data()),
+             pattern_size * sizeof(int));
+  if (flat_heuristic.empty()) {
+    FlatADD(*sV, heuristic).write(file);
+  } else {
+    flat_heuristic.write(file);
+  }
+  if (!file) {
+    cerr << "Could not write SPDB to " << file_name << endl;
+    utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+  }
+  cout << "Saved SPDB to " << file_name << endl;
 }
 
 void SPDB::create_spdb(const TaskProxy &task_proxy,
-                       const vector<int> &operator_costs) {
+                       const vector<int> &operator_costs,
+                       const SPDBParams &params) {
   BDD one = sV->oneBDD();
   BDD zero = sV->zeroBDD();
-  BDD cube = one;
-  bool abstract = 0;
-  bool debug = 0;  
-  VariablesProxy variables = task_proxy.get_variables();
+  bool debug = 0;
   initialHVal = numeric_limits<int>::max();
 
-  if (variables.size() > pattern.size()) {
-    abstract = 1;
-    for (auto var : variables) {
-      auto it = find(pattern.begin(), pattern.end(), var.get_id());
-      if (it == pattern.end()) {
-        for(int index : sV->vars_index_pre(var.get_id())) {
-          cube *= sV->bddVar(index);
-        }
-      }
-    }
-  }
-  // used for effective storing of the TR for operators of same cost.
-  std::vector<TransitionRelation *> costSortedTR;
-  for (OperatorProxy op : task_proxy.get_operators()) {
-    int op_cost;
-    if (operator_costs.empty()) {
-      op_cost = op.get_cost();
-    } else {
-      op_cost = operator_costs[op.get_id()];
-    }
-    OperatorID opID(op.get_id());
-    TransitionRelation *t = new TransitionRelation(sV, opID, op_cost);
-    t->init();
-    costSortedTR.emplace_back(t);
-  }
+  map<int, vector<TransitionRelation>> transitions =
+      create_pattern_transitions(sV.get(), task_proxy, pattern, operator_costs,
+                                 params.max_tr_time, params.max_tr_size);
   State initialState = task_proxy.get_initial_state();
   BDD initBDD = one;
   for (size_t v = 0; v < pattern.size(); v++) {
@@ -83,98 +177,182 @@ void SPDB::create_spdb(const TaskProxy &task_proxy,
   }
   initial = initBDD;
   BDD goals = one;
-  int varCount = 0;
   for (FactProxy goal : task_proxy.get_goals()) {
     int var_id = goal.get_variable().get_id();
     int val = goal.get_value();
     auto it = find(pattern.begin(), pattern.end(), var_id);    
     if (it != pattern.end()) {
       goals *= sV->preBDD(var_id, val);
-      varCount++;
     }
   }
   if (debug) {
     sV->bdd_to_dot(initial, "initialState.gv");
     sV->bdd_to_dot(goals, "goalState.gv");
   }
-  bool allGoal = 0;
-  if (varCount == pattern.size()) {
-    allGoal = 1;
-  }
   // Variable to take care of actual heuristic Value for Set of States
   int h = 0;  
   BDD actualState = goals;
   BDD visited = goals;
-  BDD explored = zero;
   closedList.emplace_back(goals);
-  while (h < closedList.size()) {
-    for (size_t t = 0; t < costSortedTR.size(); t++) {
-      BDD regressed = costSortedTR[t]->preimage(actualState);
-      int cost = costSortedTR[t]->getCost();
-      if (regressed == zero) {continue;}
-      if (abstract == 1) {
-        BDD abstracted = regressed.ExistAbstract(cube, 0);
-        regressed = abstracted;
-      }
-      if (regressed *!visited == zero) {
-        continue;
-      }
-
-      explored |= regressed;
-      int hVal = compute_value(regressed);
-
-      if (hVal == numeric_limits<int>::max() or (allGoal and hVal != numeric_limits<int>::max())) {
-        hVal = h + cost;
-        if (closedList.size() <= hVal) {
-          closedList.resize(hVal + 1, zero);
-          closedList[hVal] = regressed * !visited;
-        } else {
-          closedList[hVal] |= regressed * !visited;
+  heuristic = sV->get_manager()->constant(numeric_limits<int>::max());
+  bool truncated = false;
+  if (params.max_time < numeric_limits<int>::max()) {
+    sV->setTimeLimit(params.max_time);
+  }
+  try {
+    while (h < static_cast<int>(closedList.size())) {
+      // States reached with zero-cost operators belong to the same layer.
+      if (transitions.count(0)) {
+        BDD frontier = actualState;
+        while (frontier != zero) {
+          BDD regressed = zero;
+          for (const TransitionRelation &tr : transitions.at(0)) {
+            regressed = regressed.Or(tr.preimage(frontier, params.max_nodes),
+                                     params.max_nodes);
+          }
+          frontier = regressed * !visited;
+          closedList[h] |= frontier;
+          visited |= frontier;
         }
-      } else {
-        if (closedList[hVal] <= regressed) {
-          closedList[hVal] = regressed * !visited;
+        actualState = closedList[h];
+      }
+      add_layer(h);
+      for (const auto &cost_trs : transitions) {
+        int cost = cost_trs.first;
+        if (cost == 0) {continue;}
+        for (const TransitionRelation &tr : cost_trs.second) {
+          BDD regressed =
+              tr.preimage(actualState, params.max_nodes) * !visited;
+          if (regressed == zero) {continue;}
+          int hVal = h + cost;
+          if (static_cast<int>(closedList.size()) <= hVal) {
+            closedList.resize(hVal + 1, zero);
+          }
+          closedList[hVal] = closedList[hVal].Or(regressed, params.max_nodes);
         }
       }
+      if (debug == 1) {
+        sV->bdd_to_dot(closedList[h] , "state" + to_string((int)h) + ".gv");
+      }
+      h++;
+      if (h >= static_cast<int>(closedList.size())) {break;}
+      // Only the first (cheapest) layer in which a state is reached counts.
+      closedList[h] *= !visited;
+      actualState = closedList[h];
+      visited |= actualState;
     }
-    if (debug == 1) {
-      sV->bdd_to_dot(closedList[h] , "state" + to_string((int)h) + ".gv");
-    }
-    h++;
-    if (h >= closedList.size()) {break;}
-    actualState = closedList[h];
-    visited |= (explored | actualState);
-    if (debug == 1) {
-      sV->bdd_to_dot(closedList[h] , "state" + to_string((int)h) + ".gv");
-    }
+  } catch (BDDError e) {
+    truncated = true;
+  }
+  sV->unsetTimeLimit();
+  if (truncated) {
+    /*
+      With zero-cost operators, layer h may still miss states of distance
+      h, but no layer above h is final.
+    */
+    int min_cost = transitions.empty() ? 0 : transitions.begin()->first;
+    truncate(h, max(min_cost, 1), *params.log);
+  }
+  initialHVal = compute_value(initial);
+}
+
+void SPDB::add_layer(int h) {
+  heuristic = closedList[h].Add().Ite(sV->get_manager()->constant(h),
+                                      heuristic);
+}
+
+void SPDB::truncate(int h, int min_cost, ostream &log) {
+  /*
+    Layers 0..h-1 have been expanded completely, so every state that is
+    not reached yet has a goal distance of at least h - 1 + min_cost and
+    the layers up to that value are final.
+  */
+  int unreached_h = max(0, h - 1 + min_cost);
+  int num_final = min<int>(closedList.size(), unreached_h + 1);
+  BDD reached = sV->zeroBDD();
+  for (int i = 0; i < num_final; ++i) {
+    closedList[i] *= !reached;
+    reached |= closedList[i];
+  }
+  closedList.resize(num_final);
+  log << "SPDB construction truncated while expanding layer " << h
+      << ": " << num_final << " exact layers, all other states get h="
+      << unreached_h << endl;
+  if (static_cast<int>(closedList.size()) <= unreached_h) {
+    closedList.resize(unreached_h + 1, sV->zeroBDD());
   }
-  ADD heuristicValue = zero.Add();
-  heuristic = zero.Add();
-  for (int i = 0; i < closedList.size(); i++) {
-    ADD value = sV->get_manager()->constant(i);
-    heuristicValue = (closedList[i].Add() * value);
-    heuristic += heuristicValue;
+  closedList[unreached_h] |= !reached;
+  heuristic = sV->get_manager()->constant(numeric_limits<int>::max());
+  for (size_t i = 0; i < closedList.size(); ++i) {
+    add_layer(i);
   }
 }
 
 int SPDB::get_value(const State &state) const {
-  BDD stateBDD = sV->oneBDD();
-  for (size_t w = 0; w < pattern.size(); w++) {
-    int var_id = state[pattern[w]].get_variable().get_id();
-    int val = state[pattern[w]].get_value();
-    BDD st = sV->preBDD(var_id, val);
-    stateBDD *= st;
-  }
-  ADD hval = (stateBDD.Add() * heuristic);
-  return Cudd_V(hval.FindMax().getNode());
+  if (!flat_heuristic.empty()) {
+    return flat_heuristic.get_value(state.get_values());
+  }
+  return sV->getADDValue(heuristic, state.get_values());
 }
 
-int SPDB::compute_value(const BDD &state) const {
-  for (int h = 0; h < closedList.size(); h++) {
-    if (state <= closedList[h]) { return h; }
-    if (closedList[h] <= state) { return h; }
+void SPDB::get_values(const vector<State> &states,
+                      vector<int> &values) const {
+  auto state_value = [&states](int i, int var) {
+    return states[i].get_values()[var];
+  };
+  if (!flat_heuristic.empty()) {
+    flat_heuristic.get_values(states.size(), state_value, values);
+    return;
   }
-  return numeric_limits<int>::max();
+  vector<double> add_values;
+  sV->getADDValues(heuristic, states.size(), state_value, add_values);
+  values.assign(add_values.begin(), add_values.end());
+}
+
+void SPDB::flatten(ostream &log) {
+  if (!flat_heuristic.empty()) {
+    return;
+  }
+  int num_add_nodes = heuristic.nodeCount();
+  flat_heuristic = FlatADD(*sV, heuristic);
+  log << "Flattened heuristic ADD with " << num_add_nodes << " nodes into "
+      << flat_heuristic.memory_usage() << " bytes" << endl;
+  heuristic = ADD();
+  initial = BDD();
+  vector<BDD>().swap(closedList);
+  sV.reset();
+}
+
+vector<int> SPDB::compute_saturated_costs(
+    const TaskProxy &task_proxy, const vector<int> &operator_costs) const {
+  vector<int> saturated_costs(task_proxy.get_operators().size(), 0);
+  ADD no_state = sV->get_manager()->constant(-1);
+  for (const TransitionRelation &tr : create_operator_transitions(
+           sV.get(), task_proxy, pattern, operator_costs)) {
+    int op_id = tr.getOpsIds().begin()->get_index();
+    int num_layers = closedList.size();
+    for (int h_target = 0; h_target < num_layers; ++h_target) {
+      if (closedList[h_target] == sV->zeroBDD()) {
+        continue;
+      }
+      // Invalid encodings have no h value, so only look at valid states.
+      BDD sources = tr.preimage(closedList[h_target]) * sV->validStates();
+      ADD source_values = sources.Add().Ite(heuristic, no_state);
+      int max_h = Cudd_V(source_values.FindMax().getNode());
+      if (max_h >= 0) {
+        assert(max_h != numeric_limits<int>::max());
+        saturated_costs[op_id] =
+            max(saturated_costs[op_id], max_h - h_target);
+      }
+    }
+  }
+  return saturated_costs;
+}
+
+int SPDB::compute_value(const BDD &state) const {
+  ADD infinity = sV->get_manager()->constant(numeric_limits<int>::max());
+  ADD values = state.Add().Ite(heuristic, infinity);
+  return static_cast<int>(Cudd_V(values.FindMin().getNode()));
 }
 
 }
@@ -1,11 +1,17 @@
-#ifndef PDBS_SYMBOLIC_PATTERN_DATABASE_H
-#define PDBS_SYMBOLIC_PATTERN_DATABASE_H
+#ifndef PDBS_SPDB_H
+#define PDBS_SPDB_H
 
 #include "types.h"
 #include "pattern_database.h"
+#include "spdb_params.h"
 #include "../task_proxy.h"
 
+#include "../symbolic/flat_add.h"
 #include "../symbolic/sym_variables.h"
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -16,8 +22,9 @@ namespace pdbs {
 
 /* Implementation of a Symbolic Pattern Database.*/
 class SPDB /*: public PatternDatabase*/ {
-    // SymVariables are needed for some BDD operations
-    SymVariables *sV; 
+    // SymVariables are needed for some BDD operations. They are shared
+    // with other symbolic heuristics and outlive all BDDs of the SPDB.
+    std::shared_ptr<SymVariables> sV;
     // Pattern which is used to Abstract the planning Task
     Pattern pattern;
     // The symbolic search creates Sets of States. These are represented as 
@@ -27,9 +34,22 @@ class SPDB /*: public PatternDatabase*/ {
     // States.
     vector<vector<BDD>> heuristicValueBuckets;
     vector<BDD> closedList;
+    // Hash of the task, costs and pattern the SPDB was built for.
+    std::uint64_t fingerprint;
 
     void create_spdb(const TaskProxy &task_proxy,
-                     const vector<int> &operator_costs = vector<int>());
+                     const vector<int> &operator_costs,
+                     const SPDBParams &params);
+
+    /*
+      Called when the backward search ran out of time or nodes while
+      expanding layer h. Keeps the layers that cannot change anymore and
+      assigns the smallest possible value to all other states.
+    */
+    void truncate(int h, int min_cost, std::ostream &log);
+
+    // Assigns value h to the states of the final layer closedList[h].
+    void add_layer(int h);
 
 public:
     /*
@@ -41,22 +61,84 @@ public:
        operator_costs: Can specify individual operator costs for each
        operator. This is useful for action cost partitioning. If left
        empty, default operator costs are used.
+       params:         Time and node bounds of the construction.
     */
-    SPDB(SymVariables *sV, const TaskProxy &task_proxy, 
+    SPDB(const std::shared_ptr<SymVariables> &sV, const TaskProxy &task_proxy, 
          const Pattern &pattern,bool dump = false,
-		   	 const std::vector<int> &operator_costs = std::vector<int>());
+		   	 const std::vector<int> &operator_costs = std::vector<int>(),
+         const SPDBParams &params = SPDBParams());
     
+    /*
+      Loads an SPDB written by save(). The file must have been written
+      for a task that differs from this one at most in the initial state,
+      otherwise the planner exits with an input error. Loaded SPDBs are
+      flat and need no SymVariables.
+    */
+    SPDB(const TaskProxy &task_proxy, const std::string &file_name,
+         const std::vector<int> &operator_costs = std::vector<int>());
+
     ~SPDB() = default;
 
+    /*
+      Writes the pattern, the fingerprint of the task and the flattened
+      heuristic to a binary file.
+    */
+    void save(const std::string &file_name) const;
+
     BDD initial;
     int initialHVal;
     mutable int bestH;
+    // Maps every state to its h value, dead ends to numeric_limits<int>::max().
+    // It is extended layer by layer during construction.
     ADD heuristic;
+    // Array copy of the heuristic ADD, only built by flatten().
+    FlatADD flat_heuristic;
 
+    // Looks up the h value of the state by walking the heuristic ADD.
     int get_value(const State &state) const;
 
+    /*
+      Looks up the h values of many states at once. All states descend the
+      heuristic ADD together and split up where their values differ, so
+      the nodes on a common prefix of their paths are visited only once.
+    */
+    void get_values(const std::vector<State> &states,
+                    std::vector<int> &values) const;
+
+    /*
+      Copies the heuristic ADD into a contiguous node table that is used
+      for all subsequent lookups and releases the BDDs of the SPDB and its
+      share of the SymVariables.
+    */
+    void flatten(std::ostream &log = std::cout);
+
+    /*
+      Returns the smallest h value of the states in the set, or
+      numeric_limits<int>::max() if all of them are dead ends. Only
+      available before flatten().
+    */
     int compute_value(const BDD &state) const;
+
+    /*
+      Returns the saturated cost of every operator: the maximum of
+      h(s) - h(t) over all transitions s -> t of the operator in the
+      projection, and at least 0. Reducing the operator costs by these
+      values keeps all h values of the SPDB (as in cegar's cost
+      saturation). Only available before flatten().
+    */
+    std::vector<int> compute_saturated_costs(
+        const TaskProxy &task_proxy,
+        const std::vector<int> &operator_costs) const;
     
+    /*
+      Returns the states of each h value: layer h contains exactly the
+      states with value h, dead ends are in no layer. Only available
+      before flatten().
+    */
+    const std::vector<BDD> &get_layers() const {
+        return closedList;
+    }
+
     // Returns the pattern (i.e. all variables used) of the SPDB
     const Pattern &get_pattern() const {
         return pattern;
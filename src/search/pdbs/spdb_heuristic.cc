@@ -9,6 +9,7 @@
 
 #include <limits>
 #include <memory>
+#include <string>
 
 using namespace std;
 using namespace symbolic;
@@ -16,13 +17,20 @@ using namespace symbolic;
 namespace pdbs {
 SPDB spdb_options_creator(const shared_ptr<AbstractTask> &task,
                                      const Options &opts) {
+	if (opts.contains("load"))
+		return SPDB(TaskProxy(*task), opts.get<string>("load"));
 	shared_ptr<PatternGenerator> pattern_generator =
 	       	opts.get<shared_ptr<PatternGenerator>>("pattern");
 	Pattern pattern = pattern_generator->generate(task);
     	TaskProxy task_proxy(*task);
-   	SymVariables *sv = new SymVariables(opts);
-   	sv->init();
-   	return SPDB(sv, task_proxy, pattern, true);
+   	shared_ptr<SymVariables> sv = get_spdb_sym_variables(opts, pattern);
+   	SPDB spdb(sv, task_proxy, pattern, true, vector<int>(),
+   	          SPDBParams(opts));
+   	if (opts.contains("save"))
+   		spdb.save(opts.get<string>("save"));
+   	if (opts.get<bool>("flatten"))
+   		spdb.flatten();
+   	return spdb;
 }
 
 SPDBHeuristic::SPDBHeuristic(const Options &opts)
@@ -41,6 +49,48 @@ int SPDBHeuristic::compute_heuristic(const State &state) const {
     return h;
 }
 
+void SPDBHeuristic::compute_heuristic_batch(
+    const vector<GlobalState> &global_states, vector<int> &values) {
+    vector<State> states;
+    states.reserve(global_states.size());
+    for (const GlobalState &global_state : global_states)
+        states.push_back(convert_global_state(global_state));
+    spdb.get_values(states, values);
+    for (int &h : values) {
+        if (h == numeric_limits<int>::max())
+            h = DEAD_END;
+    }
+}
+
+void add_spdb_options_to_parser(options::OptionParser &parser) {
+    parser.add_option<bool>(
+        "flatten",
+        "copy the finished heuristic ADD into a contiguous node table, "
+        "use it for all lookups and release the BDDs",
+        "false");
+    parser.add_option<bool>(
+        "pattern_var_order",
+        "build each SPDB with its own BDD variables that only cover the "
+        "pattern, in the gamer ordering restricted to the pattern",
+        "false");
+    SPDBParams::add_options_to_parser(parser);
+    // All symbolic heuristics share the variables of the first one created.
+    SymVariables::add_options_to_parser(parser);
+}
+
+shared_ptr<SymVariables> get_spdb_sym_variables(
+    const Options &opts, const Pattern &pattern,
+    const shared_ptr<SymVariables> &shared_vars, int num_managers,
+    ostream &log) {
+    if (opts.get<bool>("pattern_var_order")) {
+        auto vars = make_shared<SymVariables>(opts);
+        vars->split_memory(num_managers);
+        vars->init(vars->compute_var_order(pattern), log);
+        return vars;
+    }
+    return shared_vars ? shared_vars : get_shared_sym_variables(opts);
+}
+
 static shared_ptr<Heuristic> _parse(OptionParser &parser) {
     parser.document_synopsis("Symbolic Pattern database heuristic", "TODO");
     parser.document_language_support("action costs", "supported");
@@ -55,6 +105,15 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
         "pattern",
         "pattern generation method",
         "greedy()");
+    parser.add_option<string>(
+        "load",
+        "read the SPDB from a file written with save instead of building "
+        "it; the file can be reused for tasks that only differ in their "
+        "initial state, the pattern option is ignored",
+        OptionParser::NONE);
+    parser.add_option<string>(
+        "save", "write the finished SPDB to this file", OptionParser::NONE);
+    add_spdb_options_to_parser(parser);
     Heuristic::add_options_to_parser(parser);
 
     Options opts = parser.parse();
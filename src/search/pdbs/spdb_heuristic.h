@@ -9,6 +9,7 @@ class GlobalState;
 class State;
 
 namespace options {
+class OptionParser;
 class Options;
 }
 using namespace symbolic;
@@ -24,6 +25,9 @@ protected:
        this, the following method already allows to get the heuristic value
        for a State object. */
     int compute_heuristic(const State &state) const;
+    virtual void compute_heuristic_batch(
+        const std::vector<GlobalState> &states,
+        std::vector<int> &values) override;
 public:
     /*
       Important: It is assumed that the pattern (passed via Options) is
@@ -36,7 +40,26 @@ public:
     */
     SPDBHeuristic(const options::Options &opts);
     virtual ~SPDBHeuristic() override = default;
+
+    virtual void get_batch_evaluators(std::set<Evaluator *> &evals) override {
+        evals.insert(this);
+    }
 };
+
+// Options shared by all heuristics that build symbolic PDBs.
+void add_spdb_options_to_parser(options::OptionParser &parser);
+
+/*
+  Returns the SymVariables to build the SPDB of the pattern with. With the
+  option pattern_var_order, these are new SymVariables that only contain
+  the variables of the pattern, which get num_managers-th of the memory
+  and write their initialization to log. Otherwise, shared_vars is
+  returned, or the shared SymVariables of the task if it is null.
+*/
+std::shared_ptr<SymVariables> get_spdb_sym_variables(
+    const options::Options &opts, const Pattern &pattern,
+    const std::shared_ptr<SymVariables> &shared_vars = nullptr,
+    int num_managers = 1, std::ostream &log = std::cout);
 }
 
 #endif
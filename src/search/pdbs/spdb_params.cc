@@ -0,0 +1,45 @@
+#include "spdb_params.h"
+
+#include "../option_parser.h"
+
+#include <iostream>
+#include <limits>
+
+using namespace std;
+
+namespace pdbs {
+SPDBParams::SPDBParams()
+    : max_tr_size(100000), max_tr_time(60000),
+      max_nodes(numeric_limits<int>::max()),
+      max_time(numeric_limits<int>::max()), log(&cout) {}
+
+SPDBParams::SPDBParams(const options::Options &opts)
+    : max_tr_size(opts.get<int>("max_tr_size")),
+      max_tr_time(opts.get<int>("max_tr_time")),
+      max_nodes(opts.get<int>("max_nodes")),
+      max_time(opts.get<int>("max_time")), log(&cout) {}
+
+void SPDBParams::print_options() const {
+  cout << "SPDB TR(time=" << max_tr_time << ", nodes=" << max_tr_size << ")"
+       << endl;
+  cout << "SPDB search(time=" << max_time << ", nodes=" << max_nodes << ")"
+       << endl;
+}
+
+void SPDBParams::add_options_to_parser(options::OptionParser &parser) {
+  parser.add_option<int>(
+      "max_tr_size", "maximum size of merged pattern TR BDDs", "100000");
+  parser.add_option<int>(
+      "max_tr_time", "maximum time (ms) to merge pattern TR BDDs", "60000");
+  parser.add_option<int>(
+      "max_nodes",
+      "maximum size of each image BDD in the backward search; when "
+      "exceeded, the SPDB is truncated",
+      "infinity", options::Bounds("1", "infinity"));
+  parser.add_option<int>(
+      "max_time",
+      "maximum time (ms) of the backward search; when exceeded, the SPDB "
+      "is truncated",
+      "infinity", options::Bounds("0", "infinity"));
+}
+}
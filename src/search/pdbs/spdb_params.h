@@ -0,0 +1,36 @@
+#ifndef PDBS_SPDB_PARAMS_H
+#define PDBS_SPDB_PARAMS_H
+
+#include <iosfwd>
+
+namespace options {
+class OptionParser;
+class Options;
+}
+
+namespace pdbs {
+/*
+  Time and node bounds for the construction of a symbolic PDB. If the
+  backward search exceeds max_time or max_nodes, the SPDB is truncated:
+  the layers that are already final keep their exact values and all
+  other states get the smallest value they may still have.
+*/
+class SPDBParams {
+public:
+  // Parameters to merge the TRs of the pattern projection
+  int max_tr_size, max_tr_time;
+
+  // Bounds on the backward search (nodes of each image, total time in ms)
+  int max_nodes, max_time;
+
+  // Stream for the output of the construction (std::cout by default)
+  std::ostream *log;
+
+  SPDBParams();
+  SPDBParams(const options::Options &opts);
+  static void add_options_to_parser(options::OptionParser &parser);
+  void print_options() const;
+};
+}
+
+#endif
@@ -0,0 +1,71 @@
+#include "spdb_transitions.h"
+
+#include "../task_proxy.h"
+
+#include "../symbolic/sym_utils.h"
+
+#include <algorithm>
+#include <set>
+
+using namespace std;
+using namespace symbolic;
+
+namespace pdbs {
+static bool induces_only_self_loops(const OperatorProxy &op,
+                                    const Pattern &pattern) {
+    for (EffectProxy eff : op.get_effects()) {
+        FactPair eff_fact = eff.get_fact().get_pair();
+        if (!binary_search(pattern.begin(), pattern.end(), eff_fact.var))
+            continue;
+        bool pre_equals_eff = false;
+        for (FactProxy pre : op.get_preconditions()) {
+            if (pre.get_pair() == eff_fact) {
+                pre_equals_eff = true;
+                break;
+            }
+        }
+        if (!pre_equals_eff)
+            return false;
+    }
+    return true;
+}
+
+vector<TransitionRelation> create_operator_transitions(
+    SymVariables *vars, const TaskProxy &task_proxy, const Pattern &pattern,
+    const vector<int> &operator_costs) {
+    set<int> abstracted_vars;
+    for (VariableProxy var : task_proxy.get_variables()) {
+        if (!binary_search(pattern.begin(), pattern.end(), var.get_id()))
+            abstracted_vars.insert(var.get_id());
+    }
+
+    vector<TransitionRelation> trs;
+    for (OperatorProxy op : task_proxy.get_operators()) {
+        if (induces_only_self_loops(op, pattern))
+            continue;
+        int cost = operator_costs.empty() ?
+            op.get_cost() : operator_costs[op.get_id()];
+        trs.emplace_back(vars, OperatorID(op.get_id()), cost);
+        trs.back().init();
+        if (!abstracted_vars.empty())
+            trs.back().abstract(abstracted_vars);
+    }
+    return trs;
+}
+
+map<int, vector<TransitionRelation>> create_pattern_transitions(
+    SymVariables *vars, const TaskProxy &task_proxy, const Pattern &pattern,
+    const vector<int> &operator_costs, int max_tr_time, int max_tr_size) {
+    vector<TransitionRelation> operator_trs =
+        create_operator_transitions(vars, task_proxy, pattern, operator_costs);
+    map<int, vector<TransitionRelation>> transitions;
+    for (TransitionRelation &tr : operator_trs) {
+        transitions[tr.getCost()].push_back(move(tr));
+    }
+
+    for (auto &cost_trs : transitions) {
+        merge(vars, cost_trs.second, mergeTR, max_tr_time, max_tr_size);
+    }
+    return transitions;
+}
+}
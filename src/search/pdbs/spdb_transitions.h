@@ -0,0 +1,41 @@
+#ifndef PDBS_SPDB_TRANSITIONS_H
+#define PDBS_SPDB_TRANSITIONS_H
+
+#include "types.h"
+
+#include "../symbolic/transition_relation.h"
+
+#include <map>
+#include <vector>
+
+class TaskProxy;
+
+namespace pdbs {
+/*
+  Creates one transition relation per operator of the projection of the
+  task onto the pattern. Non-pattern variables are quantified out and
+  operators that induce only self-loops in the projection are dropped.
+*/
+extern std::vector<symbolic::TransitionRelation>
+create_operator_transitions(symbolic::SymVariables *vars,
+                            const TaskProxy &task_proxy,
+                            const Pattern &pattern,
+                            const std::vector<int> &operator_costs);
+
+/*
+  Creates the transition relations of the projection of the task onto the
+  pattern, grouped by cost. Non-pattern variables are quantified out of the
+  TR of each operator once, operators that induce only self-loops in the
+  projection are dropped and the TRs of each cost are merged as long as the
+  merged BDDs stay below max_tr_size nodes and max_tr_time ms are not
+  exceeded (as in SymStateSpaceManager::init_transitions).
+*/
+extern std::map<int, std::vector<symbolic::TransitionRelation>>
+create_pattern_transitions(symbolic::SymVariables *vars,
+                           const TaskProxy &task_proxy,
+                           const Pattern &pattern,
+                           const std::vector<int> &operator_costs,
+                           int max_tr_time, int max_tr_size);
+}
+
+#endif
@@ -1,5 +1,7 @@
 #include "symbolic_pattern_database.h"
 
+#include "spdb_transitions.h"
+
 #include "../symbolic/transition_relation.h"
 
 #include "match_tree.h"
@@ -24,11 +26,12 @@ using namespace symbolic;
 
 namespace pdbs {
 
-SymbolicPatternDatabase::SymbolicPatternDatabase(SymVariables *sVars, 
+SymbolicPatternDatabase::SymbolicPatternDatabase(const shared_ptr<SymVariables> &sVars, 
                                                  const TaskProxy &task_proxy,
                                                  const Pattern &pattern,
                                                  bool dump,
-                                                 const vector<int> &operator_costs)
+                                                 const vector<int> &operator_costs,
+                                                 const SPDBParams &params)
 :sV(sVars), pattern(pattern) {
   task_properties::verify_no_axioms(task_proxy);
   task_properties::verify_no_conditional_effects(task_proxy);
@@ -36,17 +39,16 @@ SymbolicPatternDatabase::SymbolicPatternDatabase(SymVariables *sVars,
          operator_costs.size() == task_proxy.get_operators().size());
   assert(utils::is_sorted_unique(pattern));
   utils::Timer timer;
-  create_spdb(task_proxy, operator_costs);
+  create_spdb(task_proxy, operator_costs, params);
   if (dump)
     cout << "SymbolicPatternDatabase construction time: " << timer << endl;
 }
 
 void SymbolicPatternDatabase::create_spdb(const TaskProxy &task_proxy,
-                                          const vector<int> &operator_costs) {
+                                          const vector<int> &operator_costs,
+                                          const SPDBParams &params) {
 BDD one = sV->oneBDD();
   BDD zero = sV->zeroBDD();
-  BDD cube = one;
-  bool abstract = 0;
   bool debug = 0;  
   VariablesProxy variables = task_proxy.get_variables();
   varEval.resize(variables.size());
@@ -56,39 +58,10 @@ BDD one = sV->oneBDD();
       varEval[var.get_id()].push_back(varVal);
     }
   }
-  
-  if (variables.size() > pattern.size()) {
-    abstract = 1;
-    for (auto var : variables) {
-      auto it = find(pattern.begin(), pattern.end(), var.get_id());
-      if (it == pattern.end()) {
-        for(int index : sV->vars_index_pre(var.get_id())) {
-          cube *= sV->bddVar(index);
-        }
-      }
-    }
-  }
-  // used for effective storing of the TR for operators of same cost.
-  std::vector<TransitionRelation *> mergedTR;
-  for (OperatorProxy op : task_proxy.get_operators()) {
-    int op_cost;
-    if (operator_costs.empty()) {
-      op_cost = op.get_cost();
-    } else {
-      op_cost = operator_costs[op.get_id()];
-    }
-    OperatorID opID(op.get_id());
-    TransitionRelation *t = new TransitionRelation(sV, opID, op_cost);
-    t->init();
-    if (mergedTR.size() <= op_cost) {
-      mergedTR.resize(op_cost + 1);
-    } 
-    if (mergedTR[op_cost] == 0) {
-      mergedTR[op_cost] = t;
-    } else {
-      mergedTR[op_cost]->merge(*t, numeric_limits<int>::max());
-    }
-  }
+
+  map<int, vector<TransitionRelation>> transitions =
+      create_pattern_transitions(sV.get(), task_proxy, pattern, operator_costs,
+                                 params.max_tr_time, params.max_tr_size);
   State initialState = task_proxy.get_initial_state();
   BDD initBDD = one;
   for (size_t v = 0; v < pattern.size(); v++) {
@@ -122,27 +95,57 @@ BDD one = sV->oneBDD();
   BDD actState = goals;
   BDD vis = goals;
   closed.emplace_back(goals);
-  while (i < closed.size()){
-    for (int a = 0; a < mergedTR.size(); a++) {
-      if (mergedTR[a] == 0) { continue; }
-      BDD regression = mergedTR[a]->preimage(actState);
-      BDD abs_regression = regression.ExistAbstract(cube, 0);
-      regression = abs_regression;
-      if (regression == zero) {continue;}
-      if (closed.size() <= i + a) {
-        closed.resize(i + a + 1, zero);
-        closed[i + a] = regression * !vis;
-      } else {
-        closed[i + a] |= regression;
+  bool truncated = false;
+  if (params.max_time < numeric_limits<int>::max()) {
+    sV->setTimeLimit(params.max_time);
+  }
+  try {
+    while (i < static_cast<int>(closed.size())){
+      // States reached with zero-cost operators belong to the same layer.
+      if (transitions.count(0)) {
+        BDD frontier = actState;
+        while (frontier != zero) {
+          BDD regression = zero;
+          for (const TransitionRelation &tr : transitions.at(0)) {
+            regression = regression.Or(tr.preimage(frontier, params.max_nodes),
+                                       params.max_nodes);
+          }
+          frontier = regression * !vis;
+          closed[i] |= frontier;
+          vis |= frontier;
+        }
+        actState = closed[i];
+      }
+      for (const auto &cost_trs : transitions) {
+        int a = cost_trs.first;
+        if (a == 0) {continue;}
+        for (const TransitionRelation &tr : cost_trs.second) {
+          BDD regression = tr.preimage(actState, params.max_nodes);
+          if (regression == zero) {continue;}
+          if (static_cast<int>(closed.size()) <= i + a) {
+            closed.resize(i + a + 1, zero);
+            closed[i + a] = regression * !vis;
+          } else {
+            closed[i + a] = closed[i + a].Or(regression, params.max_nodes);
+          }
+          closed[i + a] *= !vis;
+        }
       }
-      closed[i + a] *= !vis;
+      i++;
+      if (i >= static_cast<int>(closed.size())) {break;}
+      //if ((closed[i] *= !vis) == zero) {closed.resize(i); break;}
+      closed[i] *= !vis; 
+      actState = closed[i];
+      vis |= actState;
     }
-    i++;
-    if (i >= closed.size()) {break;}
-    //if ((closed[i] *= !vis) == zero) {closed.resize(i); break;}
-    closed[i] *= !vis; 
-    actState = closed[i];
-    vis |= actState;
+  } catch (BDDError e) {
+    truncated = true;
+  }
+  sV->unsetTimeLimit();
+  if (truncated) {
+    // With zero-cost operators, layer i may still miss states of distance i.
+    int min_cost = transitions.empty() ? 0 : transitions.begin()->first;
+    truncate(i, max(min_cost, 1));
   }
   ADD heuristicValue = zero.Add();
   heuristic = zero.Add();
@@ -153,15 +156,42 @@ BDD one = sV->oneBDD();
   }
 }
 
+void SymbolicPatternDatabase::truncate(int i, int min_cost) {
+  // Layers 0..i-1 are expanded, so unreached states are at least
+  // i - 1 + min_cost away from the goal.
+  int unreached_h = max(0, i - 1 + min_cost);
+  int num_final = min<int>(closed.size(), unreached_h + 1);
+  BDD reached = sV->zeroBDD();
+  for (int j = 0; j < num_final; ++j) {
+    closed[j] *= !reached;
+    reached |= closed[j];
+  }
+  closed.resize(num_final);
+  cout << "SymbolicPatternDatabase construction truncated while expanding "
+       << "layer " << i << ": " << num_final
+       << " exact layers, all other states get h=" << unreached_h << endl;
+  if (static_cast<int>(closed.size()) <= unreached_h) {
+    closed.resize(unreached_h + 1, sV->zeroBDD());
+  }
+  closed[unreached_h] |= !reached;
+}
+
 int SymbolicPatternDatabase::get_value(const State &state) const {
-  BDD stateBDD = sV->oneBDD();
-  for (size_t w = 0; w < pattern.size(); w++) {
-    int var_id = state[pattern[w]].get_variable().get_id();
-    int val = state[pattern[w]].get_value();
-    BDD st = sV->preBDD(var_id, val);
-    stateBDD *= st;
+  if (!flat_heuristic.empty()) {
+    return flat_heuristic.get_value(state.get_values());
   }
-  return Cudd_V((stateBDD.Add() * heuristic).FindMax().getNode());
+  return sV->getADDValue(heuristic, state.get_values());
+}
+
+void SymbolicPatternDatabase::flatten() {
+  int num_add_nodes = heuristic.nodeCount();
+  flat_heuristic = FlatADD(*sV, heuristic);
+  cout << "Flattened heuristic ADD with " << num_add_nodes << " nodes into "
+       << flat_heuristic.memory_usage() << " bytes" << endl;
+  heuristic = ADD();
+  initial = BDD();
+  vector<BDD>().swap(closed);
+  vector<vector<BDD>>().swap(varEval);
 }
 
 }
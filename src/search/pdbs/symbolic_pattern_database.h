@@ -3,9 +3,12 @@
 
 #include "types.h"
 #include "pattern_database.h"
+#include "spdb_params.h"
 #include "../task_proxy.h"
 
+#include "../symbolic/flat_add.h"
 #include "../symbolic/sym_variables.h"
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -19,8 +22,9 @@ namespace pdbs {
  * build_abstract_operator,
  * */
 class SymbolicPatternDatabase /*: public PatternDatabase*/ {
-    // SymVariables are needed for some BDD operations
-    SymVariables *sV; 
+    // SymVariables are needed for some BDD operations. They are shared
+    // with other symbolic heuristics and outlive all BDDs of the SPDB.
+    std::shared_ptr<SymVariables> sV;
     // Pattern which is used to Abstract the planning Task
     Pattern pattern;
     // The symbolic search creates Sets of States. These are represented as 
@@ -46,7 +50,15 @@ class SymbolicPatternDatabase /*: public PatternDatabase*/ {
     //METHOD which needs the most Change for proper SPDB
     void create_spdb(
         const TaskProxy &task_proxy,
-        const std::vector<int> &operator_costs = std::vector<int>());
+        const std::vector<int> &operator_costs,
+        const SPDBParams &params);
+
+    /*
+      Called when the backward search ran out of time or nodes while
+      expanding layer i. Keeps the layers that cannot change anymore and
+      assigns the smallest possible value to all other states.
+    */
+    void truncate(int i, int min_cost);
 
     /*
       The given concrete state is used to calculate the index of the
@@ -64,17 +76,28 @@ public:
        operator_costs: Can specify individual operator costs for each
        operator. This is useful for action cost partitioning. If left
        empty, default operator costs are used.
+       params:         Time and node bounds of the construction.
     */
-    SymbolicPatternDatabase(SymVariables *sV, const TaskProxy &task_proxy, const Pattern &pattern,bool dump = false,
-		   	    const std::vector<int> &operator_costs = std::vector<int>());
+    SymbolicPatternDatabase(const std::shared_ptr<SymVariables> &sV, const TaskProxy &task_proxy, const Pattern &pattern,bool dump = false,
+		   	    const std::vector<int> &operator_costs = std::vector<int>(),
+                            const SPDBParams &params = SPDBParams());
     ~SymbolicPatternDatabase() = default;
     
     BDD initial;
     int initialHVal;
     mutable int bestH;
     ADD heuristic;
+    // Array copy of the heuristic ADD, only built by flatten().
+    FlatADD flat_heuristic;
 
+    // Looks up the h value of the state by walking the heuristic ADD.
     int get_value(const State &state) const;
+
+    /*
+      Copies the heuristic ADD into a contiguous node table that is used
+      for all subsequent lookups and releases the BDDs of the SPDB.
+    */
+    void flatten();
     int compute_value(const BDD &state) const;
     // Returns the pattern (i.e. all variables used) of the PDB
     const Pattern &get_pattern() const {
@@ -1,4 +1,5 @@
 #include "symbolic_pdb_heuristic.h"
+#include "spdb_heuristic.h"
 #include "../symbolic/sym_variables.h"
 
 #include "pattern_generator.h"
@@ -14,15 +15,18 @@ using namespace std;
 using namespace symbolic;
 
 namespace pdbs {
-SymbolicPatternDatabase symbolic_pdb_options_creator(const shared_ptr<AbstractTask> &task,
-                                     const Options &opts) {
-	shared_ptr<PatternGenerator> pattern_generator =
-	       	opts.get<shared_ptr<PatternGenerator>>("pattern");
-	Pattern pattern = pattern_generator->generate(task);
-    	TaskProxy task_proxy(*task);
-   	SymVariables *sv = new SymVariables(opts);
-   	sv->init();
-   	return SymbolicPatternDatabase(sv, task_proxy, pattern, true);
+SymbolicPatternDatabase symbolic_pdb_options_creator(
+    const shared_ptr<AbstractTask> &task, const Options &opts) {
+    shared_ptr<PatternGenerator> pattern_generator =
+        opts.get<shared_ptr<PatternGenerator>>("pattern");
+    Pattern pattern = pattern_generator->generate(task);
+    TaskProxy task_proxy(*task);
+    shared_ptr<SymVariables> sv = get_spdb_sym_variables(opts, pattern);
+    SymbolicPatternDatabase spdb(sv, task_proxy, pattern, true, vector<int>(),
+                                 SPDBParams(opts));
+    if (opts.get<bool>("flatten"))
+        spdb.flatten();
+    return spdb;
 }
 
 SymbolicPDBHeuristic::SymbolicPDBHeuristic(const Options &opts)
@@ -55,6 +59,7 @@ static shared_ptr<Heuristic> _parse(OptionParser &parser) {
         "pattern",
         "pattern generation method",
         "greedy()");
+    add_spdb_options_to_parser(parser);
     Heuristic::add_options_to_parser(parser);
 
     Options opts = parser.parse();
@@ -10,6 +10,10 @@ using Pattern = std::vector<int>;
 using PatternCollection = std::vector<Pattern>;
 using PDBCollection = std::vector<std::shared_ptr<PatternDatabase>>;
 using MaxAdditivePDBSubsets = std::vector<PDBCollection>;
+
+class SPDB;
+using SPDBCollection = std::vector<std::shared_ptr<SPDB>>;
+using MaxAdditiveSPDBSubsets = std::vector<SPDBCollection>;
 }
 
 #endif
@@ -13,6 +13,7 @@
 #include <cstdlib>
 #include <memory>
 #include <set>
+#include <unordered_set>
 
 using namespace std;
 
@@ -69,6 +70,14 @@ void EagerSearch::initialize() {
 
     path_dependent_evaluators.assign(evals.begin(), evals.end());
 
+    // Collect the evaluators that evaluate all new successors at once.
+    set<Evaluator *> batch_evals;
+    open_list->get_batch_evaluators(batch_evals);
+    if (f_evaluator) {
+        f_evaluator->get_batch_evaluators(batch_evals);
+    }
+    batch_evaluators.assign(batch_evals.begin(), batch_evals.end());
+
     const GlobalState &initial_state = state_registry.get_initial_state();
     for (Evaluator *evaluator : path_dependent_evaluators) {
         evaluator->notify_initial_state(initial_state);
@@ -140,13 +149,27 @@ SearchStatus EagerSearch::step() {
                                     preferred_operators);
     }
 
+    vector<OperatorID> succ_ops;
+    vector<GlobalState> succ_states;
+    succ_ops.reserve(applicable_ops.size());
+    succ_states.reserve(applicable_ops.size());
     for (OperatorID op_id : applicable_ops) {
         OperatorProxy op = task_proxy.get_operators()[op_id];
         if ((node.get_real_g() + op.get_cost()) >= bound)
             continue;
 
-        GlobalState succ_state = state_registry.get_successor_state(s, op);
+        succ_ops.push_back(op_id);
+        succ_states.push_back(state_registry.get_successor_state(s, op));
         statistics.inc_generated();
+    }
+
+    if (!batch_evaluators.empty())
+        compute_batch(succ_states);
+
+    for (size_t i = 0; i < succ_ops.size(); ++i) {
+        OperatorID op_id = succ_ops[i];
+        OperatorProxy op = task_proxy.get_operators()[op_id];
+        const GlobalState &succ_state = succ_states[i];
         bool is_preferred = preferred_operators.contains(op_id);
 
         SearchNode succ_node = search_space.get_node(succ_state);
@@ -309,6 +332,27 @@ pair<SearchNode, bool> EagerSearch::fetch_next_node() {
     }
 }
 
+void EagerSearch::compute_batch(const vector<GlobalState> &succ_states) {
+    /*
+      Only new states are evaluated, see step(). Several operators may
+      lead to the same state, which is evaluated only once.
+    */
+    vector<GlobalState> new_states;
+    new_states.reserve(succ_states.size());
+    unordered_set<int> new_state_ids;
+    for (const GlobalState &succ_state : succ_states) {
+        if (search_space.get_node(succ_state).is_new() &&
+            new_state_ids.insert(succ_state.get_id().get_value()).second)
+            new_states.push_back(succ_state);
+    }
+    if (new_states.empty())
+        return;
+    // Successors are evaluated without preferred operators, see step().
+    for (Evaluator *evaluator : batch_evaluators) {
+        evaluator->compute_batch(new_states, false);
+    }
+}
+
 void EagerSearch::reward_progress() {
     // Boost the "preferred operator" open lists somewhat whenever
     // one of the heuristics finds a state with a new best h value.
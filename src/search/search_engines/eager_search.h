@@ -22,12 +22,14 @@ class EagerSearch : public SearchEngine {
     std::shared_ptr<Evaluator> f_evaluator;
 
     std::vector<Evaluator *> path_dependent_evaluators;
+    std::vector<Evaluator *> batch_evaluators;
     std::vector<std::shared_ptr<Evaluator>> preferred_operator_evaluators;
     std::shared_ptr<Evaluator> lazy_evaluator;
 
     std::shared_ptr<PruningMethod> pruning_method;
 
     std::pair<SearchNode, bool> fetch_next_node();
+    void compute_batch(const std::vector<GlobalState> &succ_states);
     void start_f_value_statistics(EvaluationContext &eval_context);
     void update_f_value_statistics(const SearchNode &node);
     void reward_progress();
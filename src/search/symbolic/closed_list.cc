@@ -1,6 +1,7 @@
 #include "closed_list.h"
 
 #include "plan_reconstruction/sym_solution_registry.h"
+#include "sym_checkpoint.h"
 #include "sym_state_space_manager.h"
 #include "sym_utils.h"
 
@@ -57,6 +58,39 @@ BDD ClosedList::getPartialClosed(int upper_bound) const {
   return res;
 }
 
+void ClosedList::write(SymCheckpointWriter &writer) const {
+  writer.write(static_cast<int>(closed.size()));
+  for (const auto &pair : closed) {
+    writer.write(pair.first);
+    writer.write(pair.second);
+  }
+  writer.write(static_cast<int>(zeroCostClosed.size()));
+  for (const auto &pair : zeroCostClosed) {
+    writer.write(pair.first);
+    writer.write(pair.second);
+  }
+  writer.write(closedTotal);
+}
+
+void ClosedList::read(SymCheckpointReader &reader) {
+  map<int, vector<BDD>>().swap(zeroCostClosed);
+  map<int, BDD>().swap(closed);
+  int num_layers = 0;
+  reader.read(num_layers);
+  for (int i = 0; i < num_layers; ++i) {
+    int h = 0;
+    reader.read(h);
+    reader.read(closed[h]);
+  }
+  reader.read(num_layers);
+  for (int i = 0; i < num_layers; ++i) {
+    int h = 0;
+    reader.read(h);
+    reader.read(zeroCostClosed[h]);
+  }
+  reader.read(closedTotal);
+}
+
 SymSolutionCut ClosedList::getCheapestCut(const BDD &states, int g,
                                           bool fw) const {
   BDD cut_candidate = states * closedTotal;
@@ -14,6 +14,8 @@ namespace symbolic {
 class SymSolutionCut;
 class UniformCostSearch;
 class SymSearch;
+class SymCheckpointWriter;
+class SymCheckpointReader;
 
 class ClosedList {
 private:
@@ -38,6 +40,10 @@ public:
 
   BDD getPartialClosed(int upper_bound) const;
 
+  // Checkpoints of the search, read() replaces all closed states
+  void write(SymCheckpointWriter &writer) const;
+  void read(SymCheckpointReader &reader);
+
   virtual SymSolutionCut getCheapestCut(const BDD &states, int g,
                                         bool fw) const;
 
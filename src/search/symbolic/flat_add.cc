@@ -0,0 +1,106 @@
+#include "flat_add.h"
+
+#include "sym_variables.h"
+
+#include <algorithm>
+#include <cmath>
+#include <istream>
+#include <ostream>
+#include <unordered_map>
+
+using namespace std;
+
+namespace symbolic {
+
+FlatADD::FlatADD() : root(0) {}
+
+FlatADD::FlatADD(const SymVariables &vars, const ADD &add) : root(0) {
+  DdManager *mgr = vars.get_manager()->getManager();
+
+  // Collect all inner nodes reachable from the root.
+  vector<DdNode *> inner;
+  unordered_map<DdNode *, int> offset;
+  vector<DdNode *> open{add.getNode()};
+  while (!open.empty()) {
+    DdNode *node = open.back();
+    open.pop_back();
+    if (Cudd_IsConstant(node) || offset.count(node)) {
+      continue;
+    }
+    offset[node] = 0;
+    inner.push_back(node);
+    open.push_back(Cudd_T(node));
+    open.push_back(Cudd_E(node));
+  }
+
+  // Children are always on a deeper level than their parents.
+  stable_sort(inner.begin(), inner.end(), [mgr](DdNode *a, DdNode *b) {
+    return Cudd_ReadPerm(mgr, Cudd_NodeReadIndex(a)) <
+           Cudd_ReadPerm(mgr, Cudd_NodeReadIndex(b));
+  });
+  for (size_t i = 0; i < inner.size(); ++i) {
+    offset[inner[i]] = i;
+  }
+
+  auto encode = [&offset](DdNode *node) {
+    if (Cudd_IsConstant(node)) {
+      double value = Cudd_V(node);
+      assert(value >= 0 && value == floor(value));
+      return ~static_cast<int>(value);
+    }
+    return offset.at(node);
+  };
+
+  nodes.reserve(inner.size());
+  for (DdNode *node : inner) {
+    int index = Cudd_NodeReadIndex(node);
+    nodes.push_back(Node{vars.index_to_var(index), vars.index_to_bit(index),
+                         {encode(Cudd_E(node)), encode(Cudd_T(node))}});
+  }
+  root = encode(add.getNode());
+}
+
+void FlatADD::write(ostream &file) const {
+  int num_nodes = nodes.size();
+  file.write(reinterpret_cast<const char *>(&root), sizeof(root));
+  file.write(reinterpret_cast<const char *>(&num_nodes), sizeof(num_nodes));
+  file.write(reinterpret_cast<const char *>(nodes.data()),
+             num_nodes * sizeof(Node));
+}
+
+bool FlatADD::read(istream &file, int num_variables) {
+  int num_nodes = 0;
+  file.read(reinterpret_cast<char *>(&root), sizeof(root));
+  file.read(reinterpret_cast<char *>(&num_nodes), sizeof(num_nodes));
+  if (!file || num_nodes < 0) {
+    return false;
+  }
+  // Do not trust the size before checking that the file holds the nodes
+  streampos start = file.tellg();
+  file.seekg(0, ios::end);
+  streamoff available = file.tellg() - start;
+  file.seekg(start);
+  if (!file || available < static_cast<streamoff>(num_nodes * sizeof(Node))) {
+    return false;
+  }
+  nodes.resize(num_nodes);
+  file.read(reinterpret_cast<char *>(nodes.data()), num_nodes * sizeof(Node));
+  if (!file || root >= num_nodes || (num_nodes > 0 && root < 0)) {
+    return false;
+  }
+  // Children must follow their parent, so that every descent terminates
+  for (int pos = 0; pos < num_nodes; ++pos) {
+    const Node &node = nodes[pos];
+    if (node.var < 0 || node.var >= num_variables || node.bit < 0 ||
+        node.bit >= 31) {
+      return false;
+    }
+    for (int child : node.children) {
+      if (child >= num_nodes || (child >= 0 && child <= pos)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+} // namespace symbolic
@@ -0,0 +1,105 @@
+#ifndef SYMBOLIC_FLAT_ADD_H
+#define SYMBOLIC_FLAT_ADD_H
+
+#include "cuddObj.hh"
+
+#include <algorithm>
+#include <cassert>
+#include <iosfwd>
+#include <numeric>
+#include <vector>
+
+namespace symbolic {
+class SymVariables;
+
+/*
+ * Immutable copy of an integer-valued ADD stored as a contiguous node table.
+ * Nodes are ordered by BDD level, so that the root is stored first and every
+ * node precedes its children. Each node stores the var(FD) and bit it tests
+ * together with the offsets of its else and then children. A negative child
+ * is a terminal whose value v is encoded as ~v.
+ */
+class FlatADD {
+  struct Node {
+    int var;
+    int bit;
+    int children[2]; // else, then
+  };
+
+  std::vector<Node> nodes;
+  int root;
+
+public:
+  FlatADD();
+  FlatADD(const SymVariables &vars, const ADD &add);
+
+  template <class T> int get_value(const T &state) const {
+    int pos = root;
+    while (pos >= 0) {
+      const Node &node = nodes[pos];
+      pos = node.children[(state[node.var] >> node.bit) % 2];
+    }
+    return ~pos;
+  }
+
+  /*
+   * Looks up the values of num_states states at once, where
+   * state_value(i, var) is the value of var in state i. All states that
+   * take the same branch at a node descend together, so the nodes on a
+   * shared prefix of their paths are only visited once.
+   */
+  template <class StateValue>
+  void get_values(int num_states, const StateValue &state_value,
+                  std::vector<int> &values) const {
+    struct Group {
+      int pos;
+      int begin, end; // Range of the states of the group in order
+    };
+    values.resize(num_states);
+    std::vector<int> order(num_states);
+    std::iota(order.begin(), order.end(), 0);
+    std::vector<Group> open{{root, 0, num_states}};
+    while (!open.empty()) {
+      Group group = open.back();
+      open.pop_back();
+      if (group.begin == group.end) {
+        continue;
+      }
+      if (group.pos < 0) {
+        for (int k = group.begin; k < group.end; ++k) {
+          values[order[k]] = ~group.pos;
+        }
+        continue;
+      }
+      const Node &node = nodes[group.pos];
+      int mid = std::partition(order.begin() + group.begin,
+                               order.begin() + group.end,
+                               [&](int i) {
+                                 return (state_value(i, node.var) >>
+                                         node.bit) % 2 == 0;
+                               }) -
+                order.begin();
+      open.push_back({node.children[0], group.begin, mid});
+      open.push_back({node.children[1], mid, group.end});
+    }
+  }
+
+  // True for a default-constructed table that represents no ADD.
+  bool empty() const { return nodes.empty() && root == 0; }
+
+  int num_nodes() const { return nodes.size(); }
+
+  size_t memory_usage() const { return nodes.size() * sizeof(Node); }
+
+  /*
+   * Binary (de)serialization. The node table is stored as one contiguous
+   * block, so reading it back needs no CUDD manager. Read returns false if
+   * the stream ends prematurely or the table is not a valid ADD over
+   * num_variables variables, i.e. get_value() could leave the table.
+   */
+  void write(std::ostream &file) const;
+  bool read(std::istream &file, int num_variables);
+};
+} // namespace symbolic
+
+#endif
@@ -1,5 +1,6 @@
 #include "frontier.h"
 
+#include "sym_checkpoint.h"
 #include "sym_state_space_manager.h"
 
 #include "../utils/timer.h"
@@ -10,20 +11,40 @@ using utils::Timer;
 
 namespace symbolic {
 
-Frontier::Frontier() : mgr(nullptr), g_value(0) {}
+Frontier::Frontier() : mgr(nullptr), f_value(0), g_value(0) {}
 
 void Frontier::init(SymStateSpaceManager *mgr_, const BDD &bdd) {
   mgr = mgr_;
   Sfilter.push_back(bdd);
+  f_value = 0;
   g_value = 0;
 }
 
-void Frontier::set(int g, Bucket &bdd) {
+void Frontier::set(int f, int g, Bucket &bdd) {
   assert(empty());
+  f_value = f;
   g_value = g;
   Sfilter.swap(bdd);
 }
 
+void Frontier::write(SymCheckpointWriter &writer) const {
+  writer.write(Sfilter);
+  writer.write(Smerge);
+  writer.write(Szero);
+  writer.write(S);
+  writer.write(f_value);
+  writer.write(g_value);
+}
+
+void Frontier::read(SymCheckpointReader &reader) {
+  reader.read(Sfilter);
+  reader.read(Smerge);
+  reader.read(Szero);
+  reader.read(S);
+  reader.read(f_value);
+  reader.read(g_value);
+}
+
 bool Frontier::nextStepZero() const {
   return !Szero.empty() || (S.empty() && mgr->hasTransitions0());
 }
@@ -117,52 +138,59 @@ int Frontier::buckets() const {
   }
 }
 
-ResultExpansion Frontier::expand_zero(int maxTime, int maxNodes, bool fw) {
-
-  // Image with respect to 0-cost actions
-  assert(expansionReady() && nodeCount(Szero) <= maxNodes);
+ResultExpansion Frontier::compute_image(SymStateSpaceManager *image_mgr,
+                                        const Bucket &bucket, bool step_zero,
+                                        int maxTime, int maxNodes, bool fw) {
+  assert(!bucket.empty() && nodeCount(bucket) <= maxNodes);
   Timer image_time;
+  std::vector<std::map<int, Bucket>> Simg;
 
-  mgr->setTimeLimit(maxTime);
-  // Compute image, storing the result on Simg
+  image_mgr->setTimeLimit(maxTime);
   try {
-    int numImagesComputed = 0;
-    for (size_t i = 0; i < Szero.size(); i++) {
+    for (const BDD &bdd : bucket) {
       Simg.push_back(map<int, Bucket>());
-      mgr->zero_image(fw, Szero[i], Simg[i][0], maxNodes);
-      ++numImagesComputed;
+      if (step_zero) {
+        // Image with respect to 0-cost actions
+        image_mgr->zero_image(fw, bdd, Simg.back()[0], maxNodes);
+      } else {
+        image_mgr->cost_image(fw, bdd, Simg.back(), maxNodes);
+      }
     }
-    mgr->unsetTimeLimit();
+    image_mgr->unsetTimeLimit();
   } catch (BDDError e) {
-    mgr->unsetTimeLimit();
-    return ResultExpansion(true, TruncatedReason::IMAGE_ZERO, image_time());
+    image_mgr->unsetTimeLimit();
+    return ResultExpansion(step_zero,
+                           step_zero ? TruncatedReason::IMAGE_ZERO
+                                     : TruncatedReason::IMAGE_COST,
+                           image_time());
   }
 
-  Bucket().swap(Szero); // Delete Szero because it has been expanded
+  return ResultExpansion(step_zero, Simg, image_time());
+}
 
-  return ResultExpansion(true, Simg, image_time());
+Bucket Frontier::copy_prepared_bucket(SymStateSpaceManager *image_mgr) {
+  Cudd &image_manager = *image_mgr->getVars()->get_manager();
+  Bucket copy;
+  for (const BDD &bdd : prepared_bucket()) {
+    copy.push_back(bdd.Transfer(image_manager));
+  }
+  return copy;
 }
 
-ResultExpansion Frontier::expand_cost(int maxTime, int maxNodes, bool fw) {
-  assert(expansionReady());
-  assert(nodeCount(S) <= maxNodes);
-  Timer image_time;
-  mgr->setTimeLimit(maxTime);
-  try {
-    for (size_t i = 0; i < S.size(); i++) {
-      Simg.push_back(map<int, Bucket>());
-      mgr->cost_image(fw, S[i], Simg[i], maxNodes);
+void Frontier::receive_image(ResultExpansion &res) {
+  if (!res.ok) {
+    return;
+  }
+  Cudd &manager = *mgr->getVars()->get_manager();
+  for (auto &images : res.buckets) {
+    for (auto &pairCostBDDs : images) {
+      for (BDD &bdd : pairCostBDDs.second) {
+        bdd = bdd.Transfer(manager);
+      }
     }
-    mgr->unsetTimeLimit();
-  } catch (BDDError e) {
-    // Update estimation
-    mgr->unsetTimeLimit();
-
-    return ResultExpansion(false, TruncatedReason::IMAGE_COST, image_time());
   }
-
-  Bucket().swap(S); // Delete Szero because it has been expanded
-  return ResultExpansion(false, Simg, image_time());
+  // Delete the bucket because it has been expanded
+  Bucket().swap(res.step_zero ? Szero : S);
 }
 
 std::ostream &operator<<(std::ostream &os, const Frontier &frontier) {
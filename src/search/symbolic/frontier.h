@@ -9,6 +9,8 @@
 
 namespace symbolic {
 class SymStateSpaceManager;
+class SymCheckpointWriter;
+class SymCheckpointReader;
 
 class Result {
 public:
@@ -44,20 +46,13 @@ class Frontier { // Current states extracted from the open list
   Bucket Szero;   // bucket to expand 0-cost transitions
   Bucket S;       // bucket to expand cost transitions
 
-  // bucket to store temporary image results in expand_zero() and expand_cost()
-  // For each BDD in Szero or S, stores a map with pairs <cost, resImage>
-  std::vector<std::map<int, Bucket>> Simg;
-
-  int g_value;
-
-  ResultExpansion expand_zero(int maxTime, int maxNodes, bool fw);
-  ResultExpansion expand_cost(int maxTime, int maxNodes, bool fw);
+  int f_value, g_value;
 
 public:
   Frontier();
 
   void init(SymStateSpaceManager *mgr, const BDD &bdd);
-  void set(int g, Bucket &open);
+  void set(int f, int g, Bucket &open);
 
   Result prepare(int maxTime, int maxNodes, bool fw, bool initialization);
 
@@ -69,8 +64,13 @@ public:
   int nodes() const;
   int buckets() const;
 
+  int f() const { return f_value; }
   int g() const { return g_value; }
 
+  // The buckets are written as they are, whichever step is next
+  void write(SymCheckpointWriter &writer) const;
+  void read(SymCheckpointReader &reader);
+
   Bucket &prepared_bucket() {
     assert(Sfilter.empty());
     assert(Smerge.empty());
@@ -95,15 +95,36 @@ public:
 
   ResultExpansion expand(int maxTime, int maxNodes, bool fw) {
     assert(Smerge.empty() && Sfilter.empty());
-    if (!Szero.empty()) {
-      return expand_zero(maxTime, maxNodes, fw);
+    bool step_zero = !Szero.empty();
+    assert(step_zero || !S.empty());
+    ResultExpansion res =
+        compute_image(mgr, prepared_bucket(), step_zero, maxTime, maxNodes, fw);
+    if (res.ok) {
+      // Delete the bucket because it has been expanded
+      Bucket().swap(step_zero ? Szero : S);
     }
-
-    assert(!S.empty());
-    // Image with respect to cost actions
-    return expand_cost(maxTime, maxNodes, fw);
+    return res;
   }
 
+  /*
+   * Computes the images of bucket wrt the 0-cost or the cost transitions of
+   * image_mgr. For each BDD in the bucket, the result stores a map with
+   * pairs <cost, resImage>.
+   */
+  static ResultExpansion compute_image(SymStateSpaceManager *image_mgr,
+                                       const Bucket &bucket, bool step_zero,
+                                       int maxTime, int maxNodes, bool fw);
+
+  /*
+   * To expand the frontier with another CUDD manager with the same BDD
+   * variables (e.g. on another thread), the prepared bucket is copied into
+   * image_mgr, its image is computed there with compute_image() and the
+   * result is copied back with receive_image(). The copies must not
+   * overlap with other operations on either manager.
+   */
+  Bucket copy_prepared_bucket(SymStateSpaceManager *image_mgr);
+  void receive_image(ResultExpansion &res);
+
   friend std::ostream &operator<<(std::ostream &os, const Frontier &frontier);
 };
 
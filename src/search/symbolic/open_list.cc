@@ -1,54 +1,126 @@
 #include "open_list.h"
 
 #include "frontier.h"
+#include "sym_checkpoint.h"
 
 #include <cassert>
+#include <limits>
 
 namespace symbolic {
 
 void OpenList::insert(const Bucket &bucket, int g) {
   assert(!bucket.empty());
-  copyBucket(bucket, open[g]);
+  for (const BDD &bdd : bucket) {
+    if (!bdd.IsZero()) {
+      insert(bdd, g);
+    }
+  }
 }
 
 void OpenList::insert(const BDD &bdd, int g) {
   assert(!bdd.IsZero());
-  open[g].push_back(bdd);
+  if (h_layers.empty()) {
+    open[g][g].push_back(bdd);
+    return;
+  }
+
+  BDD remaining = bdd;
+  for (size_t h = 0; h < h_layers.size() && !remaining.IsZero(); ++h) {
+    BDD states = remaining * h_layers[h];
+    if (!states.IsZero()) {
+      open[g + h][g].push_back(states);
+      remaining *= !h_layers[h];
+    }
+  }
+  // Remaining states are dead ends and are pruned
 }
 
-int OpenList::minNextG(const Frontier &frontier, int min_action_cost) const {
-  int next_g = (frontier.empty() ? std::numeric_limits<int>::max()
-                                 : frontier.g() + min_action_cost);
+void OpenList::extract_states(int f, int g, Bucket &res) {
+  auto f_bucket = open.find(f);
+  assert(f_bucket != open.end() && f_bucket->second.count(g));
+  moveBucket(f_bucket->second[g], res);
+  f_bucket->second.erase(g);
+  if (f_bucket->second.empty()) {
+    open.erase(f_bucket);
+  }
+}
+
+int OpenList::minNextF(const Frontier &frontier, int min_action_cost) const {
+  // With a consistent heuristic, the successors of the frontier are not
+  // cheaper than the frontier itself
+  int next_f = std::numeric_limits<int>::max();
+  if (!frontier.empty()) {
+    next_f = h_layers.empty() ? frontier.g() + min_action_cost : frontier.f();
+  }
   if (!open.empty()) {
-    return std::min(next_g, open.begin()->first);
+    return std::min(next_f, open.begin()->first);
   }
-  return next_g;
+  return next_f;
 }
 
 void OpenList::pop(Frontier &frontier) {
   assert(frontier.empty());
-  int g = open.begin()->first;
-  frontier.set(g, open.begin()->second);
-  open.erase(g);
+  int f = open.begin()->first;
+  int g = open.begin()->second.begin()->first;
+  Bucket bucket;
+  extract_states(f, g, bucket);
+  frontier.set(f, g, bucket);
 }
 
 int OpenList::minG() const {
-  return open.empty() ? std::numeric_limits<int>::max() : open.begin()->first;
+  int min_g = std::numeric_limits<int>::max();
+  for (const auto &f_bucket : open) {
+    min_g = std::min(min_g, f_bucket.second.rbegin()->first);
+  }
+  return min_g;
 }
 
 bool OpenList::contains_any_state(const BDD &bdd) const {
-  for (auto &key : open) {
-    if (bucket_contains_any_state(key.second, bdd)) {
-      return true;
+  for (const auto &f_bucket : open) {
+    for (const auto &key : f_bucket.second) {
+      if (bucket_contains_any_state(key.second, bdd)) {
+        return true;
+      }
     }
   }
   return false;
 }
 
+void OpenList::write(SymCheckpointWriter &writer) const {
+  writer.write(static_cast<int>(open.size()));
+  for (const auto &f_bucket : open) {
+    writer.write(f_bucket.first);
+    writer.write(static_cast<int>(f_bucket.second.size()));
+    for (const auto &g_bucket : f_bucket.second) {
+      writer.write(g_bucket.first);
+      writer.write(g_bucket.second);
+    }
+  }
+}
+
+void OpenList::read(SymCheckpointReader &reader) {
+  open.clear();
+  int num_f_buckets = 0;
+  reader.read(num_f_buckets);
+  for (int i = 0; i < num_f_buckets; ++i) {
+    int f = 0;
+    int num_g_buckets = 0;
+    reader.read(f);
+    reader.read(num_g_buckets);
+    for (int j = 0; j < num_g_buckets; ++j) {
+      int g = 0;
+      reader.read(g);
+      reader.read(open[f][g]);
+    }
+  }
+}
+
 std::ostream &operator<<(std::ostream &os, const OpenList &exp) {
   os << " open{";
-  for (auto &o : exp.open) {
-    os << o.first << " ";
+  for (auto &f_bucket : exp.open) {
+    for (auto &o : f_bucket.second) {
+      os << f_bucket.first << "/" << o.first << " ";
+    }
   }
   return os << "}";
 }
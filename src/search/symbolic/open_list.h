@@ -3,14 +3,30 @@
 
 #include "sym_bucket.h"
 #include <cassert>
+#include <functional>
 #include <map>
+#include <vector>
 
 namespace symbolic {
 class SymStateSpaceManager;
 class Frontier;
+class SymCheckpointWriter;
+class SymCheckpointReader;
 
+/*
+ * States in open are kept in buckets indexed by f and g. Without a
+ * heuristic, f = g and the open list behaves like the blind open list of
+ * a uniform cost search. With a heuristic (BDDA*), each inserted BDD is
+ * split by conjunction with the heuristic layers, so that the states are
+ * popped by f without ever enumerating them. Within an f-bucket, states
+ * with higher g are popped first.
+ */
 class OpenList {
-  std::map<int, Bucket> open; // States in open with unkwown h-value
+  std::map<int, std::map<int, Bucket, std::greater<int>>> open;
+
+  // h_layers[h] contains the states with heuristic value h. States not in
+  // any layer are dead ends. Empty if the search is blind.
+  std::vector<BDD> h_layers;
 
   // At any point in the search we can close all the states in
   // open[minG()] because they cannot be generated with lower
@@ -23,6 +39,14 @@ public:
     return open.empty();
   }
 
+  // The layers must be set before any state is inserted.
+  void set_heuristic(const std::vector<BDD> &layers) {
+    assert(open.empty());
+    h_layers = layers;
+  }
+
+  bool has_heuristic() const { return !h_layers.empty(); }
+
   void insert(const Bucket &bucket, int g);
   void insert(const BDD &bdd, int g);
 
@@ -31,11 +55,16 @@ public:
   void extract_states(Bucket &bucket, int f, int g, Bucket &res, bool open);
   int minG() const;
 
-  int minNextG(const Frontier &frontier, int min_action_cost) const;
+  // Lower bound on the f-value of all states that have not been expanded
+  int minNextF(const Frontier &frontier, int min_action_cost) const;
   void pop(Frontier &frontier);
 
   bool contains_any_state(const BDD &bdd) const;
 
+  // The heuristic layers are not part of the checkpoint
+  void write(SymCheckpointWriter &writer) const;
+  void read(SymCheckpointReader &reader);
+
   friend std::ostream &operator<<(std::ostream &os, const OpenList &open);
 };
 } // namespace symbolic
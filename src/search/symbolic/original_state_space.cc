@@ -36,6 +36,42 @@ OriginalStateSpace::OriginalStateSpace(SymVariables *v,
   init_transitions(indTRs);
 }
 
+OriginalStateSpace::OriginalStateSpace(SymVariables *v,
+                                       const OriginalStateSpace &other)
+    : SymStateSpaceManager(v, other.p) {
+  Cudd &manager = *v->get_manager();
+  initialState = other.initialState.Transfer(manager);
+  goal = other.goal.Transfer(manager);
+  auto transfer_bdds = [&manager](const vector<BDD> &bdds) {
+    vector<BDD> res;
+    for (const BDD &bdd : bdds) {
+      res.push_back(bdd.Transfer(manager));
+    }
+    return res;
+  };
+  notMutexBDDsFw = transfer_bdds(other.notMutexBDDsFw);
+  notMutexBDDsBw = transfer_bdds(other.notMutexBDDsBw);
+  notDeadEndFw = transfer_bdds(other.notDeadEndFw);
+  notDeadEndBw = transfer_bdds(other.notDeadEndBw);
+
+  auto transfer_trs = [v](const map<int, vector<TransitionRelation>> &trs) {
+    map<int, vector<TransitionRelation>> res;
+    for (const auto &cost_trs : trs) {
+      for (const TransitionRelation &tr : cost_trs.second) {
+        res[cost_trs.first].emplace_back(v, tr);
+      }
+    }
+    return res;
+  };
+  transitions = transfer_trs(other.transitions);
+  individual_trs = transfer_trs(other.individual_trs);
+  for (const auto &times : other.image_times) {
+    image_times[times.first].assign(times.second.size(), 0);
+  }
+  min_transition_cost = other.min_transition_cost;
+  hasTR0 = other.hasTR0;
+}
+
 void OriginalStateSpace::create_single_trs() {
   for (int i = 0; i < tasks::g_root_task->get_num_operators(); i++) {
     int cost = tasks::g_root_task->get_operator_cost(i, false);
@@ -43,7 +79,7 @@ void OriginalStateSpace::create_single_trs() {
     // Ignore cost operators and set zero costs to 1
     // cout << "Creating TR of op " << i << " of cost " << cost << endl;
     indTRs[cost].emplace_back(vars, OperatorID(i), cost);
-    indTRs[cost].back().init();
+    indTRs[cost].back().init(p.partitioned_trs);
     if (p.mutex_type == MutexType::MUTEX_EDELETION) {
       indTRs[cost].back().edeletion(notMutexBDDsByFluentFw,
                                     notMutexBDDsByFluentBw,
@@ -16,6 +16,11 @@ class OriginalStateSpace : public SymStateSpaceManager {
 public:
   OriginalStateSpace(SymVariables *v, const SymParamsMgr &params);
 
+  // Copy of the TRs and mutex BDDs of other in the manager of v, which must
+  // have the same BDD variables, to compute images there. The individual
+  // TRs and the mutexes by fluent are not copied.
+  OriginalStateSpace(SymVariables *v, const OriginalStateSpace &other);
+
   // Individual TRs: Useful for shrink and plan construction
   std::map<int, std::vector<TransitionRelation>> indTRs;
 
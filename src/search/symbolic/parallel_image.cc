@@ -0,0 +1,149 @@
+#include "parallel_image.h"
+
+#include "sym_utils.h"
+#include "sym_variables.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace symbolic {
+ParallelImage::ParallelImage(
+    SymVariables *vars, const map<int, vector<TransitionRelation>> &trs,
+    const vector<shared_ptr<SymVariables>> &worker_vars)
+    : vars(vars) {
+  assert(!worker_vars.empty());
+  workers.resize(worker_vars.size());
+  for (size_t i = 0; i < worker_vars.size(); ++i) {
+    workers[i].vars = worker_vars[i];
+  }
+
+  // Largest TRs first, each to the worker with the fewest nodes so far
+  vector<const TransitionRelation *> sorted_trs;
+  for (const auto &cost_trs : trs) {
+    for (const TransitionRelation &tr : cost_trs.second) {
+      sorted_trs.push_back(&tr);
+    }
+  }
+  stable_sort(sorted_trs.begin(), sorted_trs.end(),
+              [](const TransitionRelation *tr1, const TransitionRelation *tr2) {
+                return tr1->nodeCount() > tr2->nodeCount();
+              });
+  vector<long> worker_nodes(workers.size(), 0);
+  for (const TransitionRelation *tr : sorted_trs) {
+    int w = min_element(worker_nodes.begin(), worker_nodes.end()) -
+            worker_nodes.begin();
+    worker_nodes[w] += tr->nodeCount();
+    workers[w].transitions[tr->getCost()].emplace_back(
+        workers[w].vars.get(), *tr);
+  }
+
+  num_tasks = 0;
+  num_running = 0;
+  stopped = false;
+  for (size_t w = 1; w < workers.size(); ++w) {
+    threads.emplace_back(&ParallelImage::run_thread, this, w);
+  }
+}
+
+ParallelImage::~ParallelImage() {
+  {
+    lock_guard<std::mutex> lock(mutex);
+    stopped = true;
+  }
+  task_started.notify_all();
+  for (thread &t : threads) {
+    t.join();
+  }
+}
+
+void ParallelImage::run_thread(size_t w) {
+  int num_done = 0;
+  unique_lock<std::mutex> lock(mutex);
+  while (true) {
+    task_started.wait(lock, [&]() { return stopped || num_tasks > num_done; });
+    if (stopped) {
+      return;
+    }
+    num_done = num_tasks;
+    lock.unlock();
+    task(w);
+    lock.lock();
+    if (--num_running == 0) {
+      task_finished.notify_one();
+    }
+  }
+}
+
+void ParallelImage::run_on_workers(const function<void(size_t)> &new_task) {
+  {
+    lock_guard<std::mutex> lock(mutex);
+    task = new_task;
+    num_running = threads.size();
+    ++num_tasks;
+  }
+  task_started.notify_all();
+  task(0);
+  unique_lock<std::mutex> lock(mutex);
+  task_finished.wait(lock, [&]() { return num_running == 0; });
+}
+
+void ParallelImage::setTimeLimit(int maxTime) {
+  for (Worker &worker : workers) {
+    worker.vars->setTimeLimit(maxTime);
+  }
+}
+
+void ParallelImage::unsetTimeLimit() {
+  for (Worker &worker : workers) {
+    worker.vars->unsetTimeLimit();
+  }
+}
+
+void ParallelImage::image(bool fw, bool zero, const BDD &bdd,
+                          map<int, Bucket> &res, int maxNodes) {
+  // Transfers must not overlap with other operations on the managers
+  vector<BDD> copies;
+  for (const Worker &worker : workers) {
+    copies.push_back(bdd.Transfer(*worker.vars->get_manager()));
+  }
+
+  vector<map<int, Bucket>> worker_res(workers.size());
+  vector<char> failed(workers.size(), false);
+  auto compute_images = [&](size_t w) {
+    try {
+      for (const auto &cost_trs : workers[w].transitions) {
+        int cost = cost_trs.first;
+        if ((cost == 0) != zero) {
+          continue;
+        }
+        Bucket &images = worker_res[w][cost];
+        for (const TransitionRelation &tr : cost_trs.second) {
+          images.push_back(fw ? tr.image(copies[w], maxNodes)
+                              : tr.preimage(copies[w], maxNodes));
+        }
+        mergeAux(images,
+                 [](BDD bdd, BDD bdd2, int maxNodes) {
+                   return bdd.Or(bdd2, maxNodes);
+                 },
+                 0, maxNodes);
+      }
+    } catch (BDDError e) {
+      failed[w] = true;
+    }
+  };
+  run_on_workers(compute_images);
+
+  if (find(failed.begin(), failed.end(), true) != failed.end()) {
+    throw BDDError();
+  }
+  Cudd &manager = *vars->get_manager();
+  for (const auto &images : worker_res) {
+    for (const auto &cost_images : images) {
+      for (const BDD &image : cost_images.second) {
+        res[cost_images.first].push_back(image.Transfer(manager));
+      }
+    }
+  }
+}
+} // namespace symbolic
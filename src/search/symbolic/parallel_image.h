@@ -0,0 +1,68 @@
+#ifndef SYMBOLIC_PARALLEL_IMAGE_H
+#define SYMBOLIC_PARALLEL_IMAGE_H
+
+#include "sym_bucket.h"
+#include "transition_relation.h"
+
+#include <condition_variable>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace symbolic {
+class SymVariables;
+
+/*
+ * Computes images wrt a set of TRs on several threads. CUDD managers are not
+ * thread-safe, so each worker has its own manager with the same BDD
+ * variables and a copy of a share of the TRs. The TRs are distributed so
+ * that all workers get roughly the same number of BDD nodes.
+ *
+ * The first worker runs on the calling thread. The others have a thread
+ * each that lives as long as this object and waits for the next image.
+ */
+class ParallelImage {
+  struct Worker {
+    std::shared_ptr<SymVariables> vars;
+    std::map<int, std::vector<TransitionRelation>> transitions;
+  };
+  SymVariables *vars;
+  std::vector<Worker> workers;
+
+  std::vector<std::thread> threads;
+  std::mutex mutex;
+  std::condition_variable task_started, task_finished;
+  std::function<void(size_t)> task; // Called with the index of each worker
+  int num_tasks;                    // Number of tasks started so far
+  int num_running;                  // Threads that run the current task
+  bool stopped;
+
+  void run_thread(size_t w);
+  // Runs task on all workers and returns once all of them are done
+  void run_on_workers(const std::function<void(size_t)> &task);
+
+public:
+  ParallelImage(SymVariables *vars,
+                const std::map<int, std::vector<TransitionRelation>> &trs,
+                const std::vector<std::shared_ptr<SymVariables>> &worker_vars);
+  ~ParallelImage();
+  ParallelImage(const ParallelImage &) = delete;
+  ParallelImage &operator=(const ParallelImage &) = delete;
+
+  void setTimeLimit(int maxTime);
+  void unsetTimeLimit();
+
+  /*
+   * Computes the images (fw) or preimages (!fw) of bdd wrt the 0-cost
+   * (zero) or the cost transitions. Each worker disjoins its images of the
+   * same cost, so res contains at most one BDD per cost and worker. Throws
+   * BDDError if any worker exceeds the time or node limit.
+   */
+  void image(bool fw, bool zero, const BDD &bdd, std::map<int, Bucket> &res,
+             int maxNodes);
+};
+} // namespace symbolic
+#endif
@@ -0,0 +1,247 @@
+#include "plan_counter.h"
+
+#include "../closed_list.h"
+#include "../../tasks/root_task.h"
+#include "../../utils/system.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+using namespace std;
+
+namespace symbolic {
+
+static const int COUNT_DIGIT_BITS = 16;
+static const double COUNT_BASE = 1 << COUNT_DIGIT_BITS;
+// Largest integer up to which all integers are exact doubles
+static const double MAX_EXACT_VALUE = 9007199254740992.0; // 2^53
+
+static DdNode *count_carry(DdManager *manager, DdNode *f) {
+  if (!Cudd_IsConstant(f)) {
+    return nullptr;
+  }
+  return Cudd_addConst(manager, floor(Cudd_V(f) / COUNT_BASE));
+}
+
+static DdNode *count_digit(DdManager *manager, DdNode *f) {
+  if (!Cudd_IsConstant(f)) {
+    return nullptr;
+  }
+  return Cudd_addConst(manager, fmod(Cudd_V(f), COUNT_BASE));
+}
+
+PlanCount::PlanCount(vector<uint32_t> digits, bool infinite)
+    : digits(move(digits)), infinite(infinite) {
+  while (!this->digits.empty() && this->digits.back() == 0) {
+    this->digits.pop_back();
+  }
+}
+
+string PlanCount::to_string() const {
+  if (infinite) {
+    return "inf";
+  }
+  // Repeated division by 10, from the most significant digit
+  vector<uint32_t> rest(digits.rbegin(), digits.rend());
+  string res;
+  while (!rest.empty()) {
+    uint64_t remainder = 0;
+    for (uint32_t &digit : rest) {
+      uint64_t value = (remainder << COUNT_DIGIT_BITS) + digit;
+      digit = value / 10;
+      remainder = value % 10;
+    }
+    res += static_cast<char>('0' + remainder);
+    rest.erase(rest.begin(),
+               find_if(rest.begin(), rest.end(),
+                       [](uint32_t digit) { return digit != 0; }));
+  }
+  if (res.empty()) {
+    res = "0";
+  }
+  reverse(res.begin(), res.end());
+  return res;
+}
+
+PlanCounter::PlanCounter(SymVariables *vars,
+                         const map<int, vector<TransitionRelation>> &trs,
+                         shared_ptr<ClosedList> closed, const BDD &init,
+                         const BDD &goal)
+    : vars(vars), trs(trs), closed(closed), goal(goal),
+      max_cost(trs.empty() ? 0 : trs.rbegin()->first), next_cost(0) {
+  paths[0] = Digits{init.Add()};
+}
+
+void PlanCounter::normalize(Digits &count) const {
+  DdManager *manager = vars->get_manager()->getManager();
+  for (size_t i = 0; i < count.size(); ++i) {
+    // An image sums at most 2^(bits of the effect variables of a TR) values
+    // below the base, so this only fails for TRs with more than 36 bits
+    if (Cudd_V(count[i].FindMax().getNode()) >= MAX_EXACT_VALUE) {
+      cerr << "Numbers of paths are too large to be summed exactly" << endl;
+      utils::exit_with(utils::ExitCode::SEARCH_UNSUPPORTED);
+    }
+    ADD carry(*vars->get_manager(),
+              Cudd_addMonadicApply(manager, count_carry, count[i].getNode()));
+    if (carry.IsZero()) {
+      continue;
+    }
+    count[i] = ADD(*vars->get_manager(),
+                   Cudd_addMonadicApply(manager, count_digit,
+                                        count[i].getNode()));
+    if (i + 1 == count.size()) {
+      count.push_back(carry);
+    } else {
+      count[i + 1] += carry;
+    }
+  }
+  while (!count.empty() && count.back().IsZero()) {
+    count.pop_back();
+  }
+}
+
+void PlanCounter::add(Digits &sum, const Digits &count) const {
+  if (sum.size() < count.size()) {
+    sum.resize(count.size(), vars->zeroBDD().Add());
+  }
+  for (size_t i = 0; i < count.size(); ++i) {
+    sum[i] += count[i];
+  }
+  normalize(sum);
+}
+
+void PlanCounter::restrict(Digits &count, const BDD &states) const {
+  ADD states_add = states.Add();
+  for (ADD &digit : count) {
+    digit *= states_add;
+  }
+  while (!count.empty() && count.back().IsZero()) {
+    count.pop_back();
+  }
+}
+
+PlanCounter::Digits PlanCounter::image(const TransitionRelation &tr,
+                                       const Digits &from) const {
+  Digits res;
+  for (const ADD &digit : from) {
+    res.push_back(tr.image(digit));
+  }
+  normalize(res);
+  return res;
+}
+
+BDD PlanCounter::get_states(const Digits &count) const {
+  BDD res = vars->zeroBDD();
+  for (const ADD &digit : count) {
+    res += digit.BddPattern();
+  }
+  return res;
+}
+
+BDD PlanCounter::zero_image(const BDD &from) const {
+  BDD res = vars->zeroBDD();
+  for (const TransitionRelation &tr : trs.at(0)) {
+    res += tr.image(from);
+  }
+  return res;
+}
+
+PlanCounter::Digits PlanCounter::zero_image(const Digits &from) const {
+  Digits res;
+  for (const TransitionRelation &tr : trs.at(0)) {
+    add(res, image(tr, from));
+  }
+  return res;
+}
+
+void PlanCounter::compute_paths(int cost) {
+  BDD closed_states = closed->get_closed_at(cost);
+  Digits res = paths.count(cost) ? paths[cost] : Digits();
+  BDD inf = vars->zeroBDD();
+  for (const auto &cost_trs : trs) {
+    int prev_cost = cost - cost_trs.first;
+    if (cost_trs.first == 0 || prev_cost < 0 || !paths.count(prev_cost)) {
+      continue;
+    }
+    auto prev_inf = infinite.find(prev_cost);
+    for (const TransitionRelation &tr : cost_trs.second) {
+      add(res, image(tr, paths[prev_cost]));
+      if (prev_inf != infinite.end() && !prev_inf->second.IsZero()) {
+        inf += tr.image(prev_inf->second);
+      }
+    }
+  }
+  restrict(res, closed_states);
+  inf *= closed_states;
+
+  if (trs.count(0)) {
+    // States of the layer reached with 0-cost actions
+    BDD reached = get_states(res) + inf;
+    for (BDD new_states = reached; !new_states.IsZero();) {
+      new_states = zero_image(new_states) * closed_states * !reached;
+      reached += new_states;
+    }
+
+    // States with arbitrarily long 0-cost paths to them are reached from a
+    // 0-cost loop. They are a fixpoint of the 0-cost image.
+    BDD looped = reached;
+    while (true) {
+      BDD next = zero_image(looped) * reached;
+      if (next == looped) {
+        break;
+      }
+      looped = next;
+    }
+    inf += looped;
+    for (BDD new_states = inf; !new_states.IsZero();) {
+      new_states = zero_image(new_states) * closed_states * !inf;
+      inf += new_states;
+    }
+
+    // The other states are not on a 0-cost loop, so the 0-cost paths
+    // between them are acyclic
+    BDD finite_states = closed_states * !inf;
+    restrict(res, finite_states);
+    Digits new_paths = res;
+    while (!new_paths.empty()) {
+      new_paths = zero_image(new_paths);
+      restrict(new_paths, finite_states);
+      add(res, new_paths);
+    }
+  } else {
+    restrict(res, !inf);
+  }
+  paths[cost] = res;
+  infinite[cost] = inf;
+}
+
+PlanCount PlanCounter::count_plans(int cost) {
+  assert(cost >= next_cost);
+  for (; next_cost <= cost; ++next_cost) {
+    compute_paths(next_cost);
+    // Layers that cannot be reached with another action any more
+    paths.erase(paths.begin(), paths.lower_bound(next_cost - max_cost));
+    infinite.erase(infinite.begin(),
+                   infinite.lower_bound(next_cost - max_cost));
+  }
+  if (!(infinite[cost] * goal).IsZero()) {
+    return PlanCount(vector<uint32_t>(), true);
+  }
+  // Sum over one variable at a time, so that each sum stays exact
+  Digits num_plans = paths[cost];
+  restrict(num_plans, goal);
+  for (int var = 0; var < tasks::g_root_task->get_num_variables(); ++var) {
+    ADD var_cube = vars->getCubePre(var).Add();
+    for (ADD &digit : num_plans) {
+      digit = digit.ExistAbstract(var_cube);
+    }
+    normalize(num_plans);
+  }
+  vector<uint32_t> digits;
+  for (const ADD &digit : num_plans) {
+    digits.push_back(Cudd_V(digit.getNode()));
+  }
+  return PlanCount(digits);
+}
+} // namespace symbolic
@@ -0,0 +1,92 @@
+#ifndef SYMBOLIC_PLAN_RECONSTRUCTION_PLAN_COUNTER_H
+#define SYMBOLIC_PLAN_RECONSTRUCTION_PLAN_COUNTER_H
+
+#include "../sym_variables.h"
+#include "../transition_relation.h"
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace symbolic {
+class ClosedList;
+
+/*
+ * Exact number of plans, which may be infinite. The digits are in base
+ * 2^16, the least significant first.
+ */
+class PlanCount {
+  std::vector<uint32_t> digits;
+  bool infinite;
+
+public:
+  explicit PlanCount(std::vector<uint32_t> digits, bool infinite = false);
+
+  bool is_zero() const { return !infinite && digits.empty(); }
+  bool is_infinite() const { return infinite; }
+
+  // Decimal representation, "inf" if infinite
+  std::string to_string() const;
+};
+
+/*
+ * Counts the plans of each cost without reconstructing them. For each cost
+ * g, ADDs map every state to the number of paths of cost g from the
+ * initial state to it. It is the sum of the images of the ADDs of smaller
+ * costs wrt the individual TRs, restricted to the forward closed list at
+ * g (which applies the same mutex pruning as the search). The number of
+ * plans of cost g is the sum of the ADDs over the goal states.
+ *
+ * ADD terminals are doubles, so each number of paths is split into digits
+ * in base 2^16 with one ADD per digit. After each sum, the carries are
+ * propagated to the next digit, which keeps all terminals far below 2^53
+ * and the counts exact.
+ *
+ * States that are reached from a 0-cost loop, directly or through states of
+ * smaller costs, have infinitely many paths. They are kept in a BDD per cost
+ * instead of the ADDs, so the count is only infinite if such a state is a
+ * goal state.
+ */
+class PlanCounter {
+  // Digits of the number of paths to each state, the least significant
+  // first. Zero has no digits.
+  using Digits = std::vector<ADD>;
+
+  SymVariables *vars;
+  const std::map<int, std::vector<TransitionRelation>> &trs;
+  std::shared_ptr<ClosedList> closed;
+  BDD goal;
+  int max_cost;
+
+  std::map<int, Digits> paths; // Number of paths of each cost to each state
+  std::map<int, BDD> infinite; // States with infinitely many paths
+  int next_cost;
+
+  // Brings all digits below the base, propagating the carries
+  void normalize(Digits &count) const;
+  void add(Digits &sum, const Digits &count) const;
+  void restrict(Digits &count, const BDD &states) const;
+  Digits image(const TransitionRelation &tr, const Digits &from) const;
+  BDD get_states(const Digits &count) const;
+
+  // Sum of the 0-cost images of from
+  BDD zero_image(const BDD &from) const;
+  Digits zero_image(const Digits &from) const;
+
+  void compute_paths(int cost);
+
+public:
+  PlanCounter(SymVariables *vars,
+              const std::map<int, std::vector<TransitionRelation>> &trs,
+              std::shared_ptr<ClosedList> closed, const BDD &init,
+              const BDD &goal);
+
+  // Number of plans of the given cost, which has to be larger than the
+  // costs of previous calls. The closed list has to be complete up to it.
+  PlanCount count_plans(int cost);
+};
+} // namespace symbolic
+
+#endif
@@ -1,5 +1,6 @@
 #include "sym_solution_registry.h"
 #include "../searches/uniform_cost_search.h"
+#include "../sym_checkpoint.h"
 #include "../tasks/root_task.h"
 
 namespace symbolic {
@@ -16,7 +17,9 @@ BDD SymSolutionRegistry::get_resulting_state(const Plan &plan) const {
   return sym_vars->getStateBDD(cur);
 }
 
-void SymSolutionRegistry::add_plan(const Plan &plan) const {
+void SymSolutionRegistry::add_plan(const Plan &plan) {
+  int num_plans = plan_data_base->get_num_accepted_plans() +
+                  plan_data_base->get_num_rejected_plans();
   plan_data_base->add_plan(plan);
   if (!plan_data_base->found_enough_plans() && task_has_zero_costs() &&
       plan_data_base->has_zero_cost_loop(plan)) {
@@ -31,10 +34,19 @@ void SymSolutionRegistry::add_plan(const Plan &plan) const {
       plan_data_base->add_plan(cur_plan);
     }
   }
+
+  // All states of the cuts are on goal paths with the cost of the plan
+  if (num_plans < plan_data_base->get_num_accepted_plans() +
+                      plan_data_base->get_num_rejected_plans()) {
+    for (size_t i = num_registered_path_cuts; i < path_cuts.size(); ++i) {
+      plan_data_base->add_states_on_goal_paths(path_cuts[i]);
+    }
+    num_registered_path_cuts = path_cuts.size();
+  }
 }
 
 void SymSolutionRegistry::reconstruct_plans(const SymSolutionCut &cut) {
-  Plan plan;
+  assert(tasks.empty() && path_cuts.empty());
   SymSolutionCut modifiable_cut = cut;
 
   if (fw_search && !bw_search) {
@@ -44,51 +56,106 @@ void SymSolutionRegistry::reconstruct_plans(const SymSolutionCut &cut) {
     modifiable_cut.set_g(0);
   }
 
-  if (fw_search) {
-    extract_all_plans(modifiable_cut, true, plan);
-  } else {
-    extract_all_plans(modifiable_cut, false, plan);
-  }
+  push_task(ReconstructionTask::Type::EXTRACT, modifiable_cut,
+            fw_search != nullptr, Plan());
 }
 
-void SymSolutionRegistry::extract_all_plans(SymSolutionCut &sym_cut, bool fw,
-                                            Plan plan) {
-  if (plan_data_base->found_enough_plans()) {
-    return;
+void SymSolutionRegistry::enumerate_plans() {
+  while (!tasks.empty() && !plan_data_base->found_enough_plans()) {
+    ReconstructionTask &task = tasks.back();
+    switch (task.type) {
+    case ReconstructionTask::Type::EXTRACT: {
+      ReconstructionTask extract_task = task;
+      tasks.pop_back();
+      expand_extract_task(extract_task);
+      break;
+    }
+    case ReconstructionTask::Type::ADD_PLAN: {
+      Plan plan = task.plan;
+      tasks.pop_back();
+      add_plan(plan);
+      break;
+    }
+    case ReconstructionTask::Type::COST_ACTIONS:
+      if (!next_cost_action(task)) {
+        tasks.pop_back();
+      }
+      break;
+    case ReconstructionTask::Type::ZERO_ACTIONS:
+      if (!next_zero_action(task)) {
+        tasks.pop_back();
+      }
+      break;
+    case ReconstructionTask::Type::POP_PATH_CUT:
+      tasks.pop_back();
+      path_cuts.pop_back();
+      num_registered_path_cuts =
+          std::min(num_registered_path_cuts, path_cuts.size());
+      break;
+    }
   }
+}
 
+void SymSolutionRegistry::push_task(ReconstructionTask::Type type,
+                                    const SymSolutionCut &cut, bool fw,
+                                    const Plan &plan) {
+  tasks.emplace_back(type, cut, fw, plan);
+  tasks.back().cost_trs = trs.begin();
+}
+
+std::shared_ptr<ClosedList> SymSolutionRegistry::get_closed(bool fw) const {
+  return fw ? fw_search->getClosedShared() : bw_search->getClosedShared();
+}
+
+void SymSolutionRegistry::expand_extract_task(const ReconstructionTask &task) {
+  std::vector<ReconstructionTask> subtasks;
   if (!task_has_zero_costs()) {
-    extract_all_cost_plans(sym_cut, fw, plan);
+    expand_extract_cost_task(task, subtasks);
   } else {
-    extract_all_zero_plans(sym_cut, fw, plan);
+    expand_extract_zero_task(task, subtasks);
+  }
+
+  path_cuts.push_back(task.cut.get_cut());
+  push_task(ReconstructionTask::Type::POP_PATH_CUT, task.cut, task.fw,
+            Plan());
+  // The first subtask has to be on top of the stack
+  for (auto it = subtasks.rbegin(); it != subtasks.rend(); ++it) {
+    tasks.push_back(*it);
+    tasks.back().cost_trs = trs.begin();
   }
 }
 
-void SymSolutionRegistry::extract_all_cost_plans(SymSolutionCut &sym_cut,
-                                                 bool fw, Plan &plan) {
-  // std::cout << sym_cut << std::endl;
+void SymSolutionRegistry::expand_extract_cost_task(
+    const ReconstructionTask &task,
+    std::vector<ReconstructionTask> &subtasks) {
+  using Type = ReconstructionTask::Type;
+  const SymSolutionCut &sym_cut = task.cut;
+  const Plan &plan = task.plan;
   if (sym_cut.get_g() == 0 && sym_cut.get_h() == 0) {
-    add_plan(plan);
+    subtasks.emplace_back(Type::ADD_PLAN, sym_cut, task.fw, plan);
     return;
   }
 
   // Resolve cost action
-  if (fw) {
+  if (task.fw) {
     if (sym_cut.get_g() > 0) {
-      reconstruct_cost_action(sym_cut, true, fw_search->getClosedShared(),
-                              plan);
+      subtasks.emplace_back(Type::COST_ACTIONS, sym_cut, true, plan);
     } else {
       SymSolutionCut new_cut(0, sym_cut.get_h(), get_resulting_state(plan));
-      reconstruct_cost_action(new_cut, false, bw_search->getClosedShared(),
-                              plan);
+      subtasks.emplace_back(Type::COST_ACTIONS, new_cut, false, plan);
     }
   } else {
-    reconstruct_cost_action(sym_cut, false, bw_search->getClosedShared(), plan);
+    subtasks.emplace_back(Type::COST_ACTIONS, sym_cut, false, plan);
   }
 }
 
-void SymSolutionRegistry::extract_all_zero_plans(SymSolutionCut &sym_cut,
-                                                 bool fw, Plan &plan) {
+void SymSolutionRegistry::expand_extract_zero_task(
+    const ReconstructionTask &task,
+    std::vector<ReconstructionTask> &subtasks) {
+  using Type = ReconstructionTask::Type;
+  const SymSolutionCut &sym_cut = task.cut;
+  const Plan &plan = task.plan;
+  bool fw = task.fw;
   BDD intersection;
   // Only zero costs left!
   if (sym_cut.get_g() == 0 && sym_cut.get_h() == 0) {
@@ -97,13 +164,9 @@ void SymSolutionRegistry::extract_all_zero_plans(SymSolutionCut &sym_cut,
       intersection =
           sym_cut.get_cut() * fw_search->getClosedShared()->get_start_states();
       if (!intersection.IsZero()) {
-        add_plan(plan);
-        if (plan_data_base->found_enough_plans()) {
-          return;
-        }
+        subtasks.emplace_back(Type::ADD_PLAN, sym_cut, fw, plan);
       }
-      reconstruct_zero_action(sym_cut, true, fw_search->getClosedShared(),
-                              plan);
+      subtasks.emplace_back(Type::ZERO_ACTIONS, sym_cut, true, plan);
     } else if (fw && bw_search) {
       intersection =
           sym_cut.get_cut() * fw_search->getClosedShared()->get_start_states();
@@ -113,138 +176,119 @@ void SymSolutionRegistry::extract_all_zero_plans(SymSolutionCut &sym_cut,
         intersection = new_cut.get_cut() *
                        bw_search->getClosedShared()->get_start_states();
         if (!intersection.IsZero()) {
-          add_plan(plan);
-          if (plan_data_base->found_enough_plans()) {
-            return;
-          }
+          subtasks.emplace_back(Type::ADD_PLAN, new_cut, fw, plan);
         }
-        reconstruct_zero_action(new_cut, false, bw_search->getClosedShared(),
-                                plan);
+        subtasks.emplace_back(Type::ZERO_ACTIONS, new_cut, false, plan);
       }
-      reconstruct_zero_action(sym_cut, true, fw_search->getClosedShared(),
-                              plan);
+      subtasks.emplace_back(Type::ZERO_ACTIONS, sym_cut, true, plan);
     } else { // bw
       intersection =
           sym_cut.get_cut() * bw_search->getClosedShared()->get_start_states();
       if (!intersection.IsZero()) {
-        add_plan(plan);
-        if (plan_data_base->found_enough_plans()) {
-          return;
-        }
+        subtasks.emplace_back(Type::ADD_PLAN, sym_cut, fw, plan);
       }
-      reconstruct_zero_action(sym_cut, false, bw_search->getClosedShared(),
-                              plan);
+      subtasks.emplace_back(Type::ZERO_ACTIONS, sym_cut, false, plan);
     }
   } else {
     // Some cost left!
     if (fw) {
       if (sym_cut.get_g() > 0) {
-        reconstruct_cost_action(sym_cut, true, fw_search->getClosedShared(),
-                                plan);
+        subtasks.emplace_back(Type::COST_ACTIONS, sym_cut, true, plan);
       } else {
         intersection = sym_cut.get_cut() *
                        fw_search->getClosedShared()->get_start_states();
         if (!intersection.IsZero()) {
           SymSolutionCut new_cut(0, sym_cut.get_h(), get_resulting_state(plan));
-          reconstruct_cost_action(new_cut, false, bw_search->getClosedShared(),
-                                  plan);
-          reconstruct_zero_action(new_cut, false, bw_search->getClosedShared(),
-                                  plan);
+          subtasks.emplace_back(Type::COST_ACTIONS, new_cut, false, plan);
+          subtasks.emplace_back(Type::ZERO_ACTIONS, new_cut, false, plan);
         }
       }
-      reconstruct_zero_action(sym_cut, true, fw_search->getClosedShared(),
-                              plan);
+      subtasks.emplace_back(Type::ZERO_ACTIONS, sym_cut, true, plan);
     } else {
-      reconstruct_cost_action(sym_cut, false, bw_search->getClosedShared(),
-                              plan);
-      reconstruct_zero_action(sym_cut, false, bw_search->getClosedShared(),
-                              plan);
+      subtasks.emplace_back(Type::COST_ACTIONS, sym_cut, false, plan);
+      subtasks.emplace_back(Type::ZERO_ACTIONS, sym_cut, false, plan);
     }
   }
 }
 
-bool SymSolutionRegistry::reconstruct_zero_action(
-    SymSolutionCut &sym_cut, bool fw, std::shared_ptr<ClosedList> closed,
-    const Plan &plan) {
-  int cur_cost = fw ? sym_cut.get_g() : sym_cut.get_h();
-  BDD cut = sym_cut.get_cut();
-
-  bool some_action_found = false;
-  BDD succ;
-  for (size_t newSteps0 = 0;
-       newSteps0 < closed->get_num_zero_closed_layers(cur_cost); newSteps0++) {
-    for (const TransitionRelation &tr : trs.at(0)) {
-      succ = fw ? tr.preimage(cut) : tr.image(cut);
+bool SymSolutionRegistry::next_zero_action(ReconstructionTask &task) {
+  int cur_cost = task.fw ? task.cut.get_g() : task.cut.get_h();
+  std::shared_ptr<ClosedList> closed = get_closed(task.fw);
+  const std::vector<TransitionRelation> &zero_trs = trs.at(0);
+
+  for (; task.zero_layer < closed->get_num_zero_closed_layers(cur_cost);
+       task.zero_layer++, task.tr = 0) {
+    while (task.tr < zero_trs.size()) {
+      const TransitionRelation &tr = zero_trs[task.tr++];
+      BDD succ = task.fw ? tr.preimage(task.cut.get_cut())
+                         : tr.image(task.cut.get_cut());
       if (succ.IsZero()) {
         continue;
       }
 
-      BDD intersection = succ * closed->get_zero_closed_at(cur_cost, newSteps0);
+      BDD intersection =
+          succ * closed->get_zero_closed_at(cur_cost, task.zero_layer);
       if (!intersection.IsZero()) {
-        Plan new_plan = plan;
-        some_action_found = true;
-        if (fw) {
+        Plan new_plan = task.plan;
+        if (task.fw) {
           new_plan.insert(new_plan.begin(), *(tr.getOpsIds().begin()));
         } else {
           new_plan.push_back(*(tr.getOpsIds().begin()));
         }
-        SymSolutionCut new_cut(sym_cut.get_g(), sym_cut.get_h(), intersection);
-        extract_all_plans(new_cut, fw, new_plan);
-
-        if (plan_data_base->found_enough_plans()) {
-          return true;
-        }
+        SymSolutionCut new_cut(task.cut.get_g(), task.cut.get_h(),
+                               intersection);
+        // The stack may grow, task must not be used afterwards
+        push_task(ReconstructionTask::Type::EXTRACT, new_cut, task.fw,
+                  new_plan);
+        return true;
       }
     }
   }
-  return some_action_found;
+  return false;
 }
 
-bool SymSolutionRegistry::reconstruct_cost_action(
-    SymSolutionCut &sym_cut, bool fw, std::shared_ptr<ClosedList> closed,
-    const Plan &plan) {
-  int cur_cost = fw ? sym_cut.get_g() : sym_cut.get_h();
-  bool some_action_found = false;
+bool SymSolutionRegistry::next_cost_action(ReconstructionTask &task) {
+  int cur_cost = task.fw ? task.cut.get_g() : task.cut.get_h();
+  std::shared_ptr<ClosedList> closed = get_closed(task.fw);
 
-  for (auto key : trs) {
-    int new_cost = cur_cost - key.first;
-    if (key.first == 0 || new_cost < 0) {
+  for (; task.cost_trs != trs.end(); ++task.cost_trs, task.tr = 0) {
+    int new_cost = cur_cost - task.cost_trs->first;
+    if (task.cost_trs->first == 0 || new_cost < 0) {
       continue;
     }
-    for (TransitionRelation &tr : key.second) {
-      BDD succ =
-          fw ? tr.preimage(sym_cut.get_cut()) : tr.image(sym_cut.get_cut());
+    while (task.tr < task.cost_trs->second.size()) {
+      const TransitionRelation &tr = task.cost_trs->second[task.tr++];
+      BDD succ = task.fw ? tr.preimage(task.cut.get_cut())
+                         : tr.image(task.cut.get_cut());
       BDD intersection = succ * closed->get_closed_at(new_cost);
       if (intersection.IsZero()) {
         continue;
       }
-      Plan new_plan = plan;
-      some_action_found = true;
+      Plan new_plan = task.plan;
       SymSolutionCut new_cut(0, 0, intersection);
-      if (fw) {
+      if (task.fw) {
         new_plan.insert(new_plan.begin(), *(tr.getOpsIds().begin()));
         new_cut.set_g(new_cost);
-        new_cut.set_h(sym_cut.get_h());
+        new_cut.set_h(task.cut.get_h());
       } else {
         new_plan.push_back(*(tr.getOpsIds().begin()));
-        new_cut.set_g(sym_cut.get_g());
+        new_cut.set_g(task.cut.get_g());
         new_cut.set_h(new_cost);
       }
-      extract_all_plans(new_cut, fw, new_plan);
-
-      if (plan_data_base->found_enough_plans()) {
-        return true;
-      }
+      // The stack may grow, task must not be used afterwards
+      push_task(ReconstructionTask::Type::EXTRACT, new_cut, task.fw, new_plan);
+      return true;
     }
   }
-  return some_action_found;
+  return false;
 }
 
 ////// Plan registry
 
 SymSolutionRegistry::SymSolutionRegistry()
     : single_solution(true), sym_vars(nullptr), fw_search(nullptr),
-      bw_search(nullptr), plan_data_base(nullptr), plan_cost_bound(-1) {}
+      bw_search(nullptr), plan_data_base(nullptr), plan_cost_bound(-1),
+      num_registered_path_cuts(0) {}
 
 void SymSolutionRegistry::init(std::shared_ptr<SymVariables> sym_vars,
                                UniformCostSearch *fwd_search,
@@ -290,12 +334,91 @@ void SymSolutionRegistry::register_solution(const SymSolutionCut &solution) {
   }
 }
 
+static void write_cut(SymCheckpointWriter &writer, const SymSolutionCut &cut) {
+  writer.write(cut.get_g());
+  writer.write(cut.get_h());
+  writer.write(cut.get_cut());
+}
+
+static SymSolutionCut read_cut(SymCheckpointReader &reader) {
+  int g = 0;
+  int h = 0;
+  BDD cut;
+  reader.read(g);
+  reader.read(h);
+  reader.read(cut);
+  return SymSolutionCut(g, h, cut);
+}
+
+void SymSolutionRegistry::write(SymCheckpointWriter &writer) const {
+  writer.write(plan_cost_bound);
+  writer.write(static_cast<int>(sym_cuts.size()));
+  for (const SymSolutionCut &cut : sym_cuts) {
+    write_cut(writer, cut);
+  }
+
+  writer.write(static_cast<int>(tasks.size()));
+  for (const ReconstructionTask &task : tasks) {
+    writer.write(static_cast<int>(task.type));
+    write_cut(writer, task.cut);
+    writer.write(task.fw);
+    writer.write(task.plan);
+    writer.write(static_cast<int>(std::distance(trs.begin(), task.cost_trs)));
+    writer.write(task.zero_layer);
+    writer.write(task.tr);
+  }
+  writer.write(path_cuts);
+  writer.write(num_registered_path_cuts);
+}
+
+void SymSolutionRegistry::read(SymCheckpointReader &reader) {
+  reader.read(plan_cost_bound);
+  int num_cuts = 0;
+  reader.read(num_cuts);
+  sym_cuts.clear();
+  for (int i = 0; i < num_cuts; ++i) {
+    sym_cuts.push_back(read_cut(reader));
+  }
+
+  int num_tasks = 0;
+  reader.read(num_tasks);
+  tasks.clear();
+  for (int i = 0; i < num_tasks; ++i) {
+    int type = 0;
+    reader.read(type);
+    if (type < static_cast<int>(ReconstructionTask::Type::EXTRACT) ||
+        type > static_cast<int>(ReconstructionTask::Type::POP_PATH_CUT)) {
+      reader.exit_with_error("unknown reconstruction task");
+    }
+    SymSolutionCut cut = read_cut(reader);
+    bool fw = true;
+    Plan plan;
+    reader.read(fw);
+    reader.read(plan);
+    push_task(static_cast<ReconstructionTask::Type>(type), cut, fw, plan);
+
+    int cost_trs = 0;
+    reader.read(cost_trs);
+    if (cost_trs < 0 || cost_trs > static_cast<int>(trs.size())) {
+      reader.exit_with_error("the transition relations do not match");
+    }
+    std::advance(tasks.back().cost_trs, cost_trs);
+    reader.read(tasks.back().zero_layer);
+    reader.read(tasks.back().tr);
+  }
+  reader.read(path_cuts);
+  reader.read(num_registered_path_cuts);
+}
+
 void SymSolutionRegistry::construct_cheaper_solutions(int bound) {
   bool bound_used = false;
   int min_plan_bound = std::numeric_limits<int>::max();
 
-  while (sym_cuts.size() > 0 && sym_cuts.at(0).get_f() < bound &&
-         !found_all_plans()) {
+  // Continue with the plans of the last cut
+  enumerate_plans();
+
+  while (tasks.empty() && sym_cuts.size() > 0 &&
+         sym_cuts.at(0).get_f() < bound && !found_all_plans()) {
 
     // Ignore cuts with costs smaller than the proven cost bound
     // This occurs only in bidirectional search
@@ -306,6 +429,7 @@ void SymSolutionRegistry::construct_cheaper_solutions(int bound) {
       bound_used = true;
       reconstruct_plans(sym_cuts[0]);
       sym_cuts.erase(sym_cuts.begin());
+      enumerate_plans();
     }
   }
 
@@ -313,5 +437,10 @@ void SymSolutionRegistry::construct_cheaper_solutions(int bound) {
   if (bound_used) {
     plan_cost_bound = min_plan_bound;
   }
+
+  // Plans that are counted as found must survive if the planner is killed
+  if (plan_data_base) {
+    plan_data_base->flush_plans();
+  }
 }
 } // namespace symbolic
@@ -12,6 +12,8 @@
 namespace symbolic {
 class UniformCostSearch;
 class ClosedList;
+class SymCheckpointWriter;
+class SymCheckpointReader;
 
 class SymSolutionRegistry {
 protected:
@@ -26,31 +28,69 @@ protected:
   std::map<int, std::vector<TransitionRelation>> trs;
   int plan_cost_bound;
 
+  // Cuts of the current reconstruction path. The first
+  // num_registered_path_cuts have already been added to the goal path states
+  std::vector<BDD> path_cuts;
+  size_t num_registered_path_cuts;
+
   bool task_has_zero_costs() const { return trs.count(0) > 0; }
 
   BDD get_resulting_state(const Plan &plan) const;
 
+  /*
+   * Plans are enumerated by a DFS with an explicit stack of tasks, so that
+   * the enumeration stops as soon as enough plans are found and continues
+   * from the same point when more plans are needed.
+   * BID: After reconstruction of the forward part we reverse the plan and
+   * extract all plans in bw direction which completes the plan
+   */
+  struct ReconstructionTask {
+    enum class Type {
+      EXTRACT,      // Extract all plans of the cut with the plan suffix
+      ADD_PLAN,     // Report the (complete) plan
+      COST_ACTIONS, // Extract with each cost action that reaches the cut
+      ZERO_ACTIONS, // Extract with each 0-cost action that reaches the cut
+      POP_PATH_CUT  // The cut of an EXTRACT task has been processed
+    };
+    Type type;
+    SymSolutionCut cut;
+    bool fw;
+    Plan plan;
+    // Next TR to try in COST_ACTIONS and ZERO_ACTIONS
+    std::map<int, std::vector<TransitionRelation>>::const_iterator cost_trs;
+    size_t zero_layer;
+    size_t tr;
+
+    ReconstructionTask(Type type, const SymSolutionCut &cut, bool fw,
+                       const Plan &plan)
+        : type(type), cut(cut), fw(fw), plan(plan), zero_layer(0), tr(0) {}
+  };
+  std::vector<ReconstructionTask> tasks;
+
+  // Starts the enumeration of the plans of the cut
   void reconstruct_plans(const SymSolutionCut &cut);
 
-  void add_plan(const Plan &plan) const;
+  // Runs the enumeration until it is finished or enough plans are found
+  void enumerate_plans();
+
+  void push_task(ReconstructionTask::Type type, const SymSolutionCut &cut,
+                 bool fw, const Plan &plan);
+  void expand_extract_task(const ReconstructionTask &task);
+  void expand_extract_cost_task(const ReconstructionTask &task,
+                                std::vector<ReconstructionTask> &subtasks);
+  void expand_extract_zero_task(const ReconstructionTask &task,
+                                std::vector<ReconstructionTask> &subtasks);
 
-  // Extracts all plans by a DFS, we copy the current plan suffix by every
-  // recusive call which is why we don't use any reference for plan
-  // BID: After reconstruction of the forward part we reverse the plan and
-  // call extract_all_plans in bw direction which completes the plan
-  // After completing a plan we store it in found plans!
-  void extract_all_plans(SymSolutionCut &sym_cut, bool fw, Plan plan);
+  // Advance the task to its next action and push the corresponding
+  // EXTRACT task. Return false if there are no actions left
+  bool next_cost_action(ReconstructionTask &task);
+  bool next_zero_action(ReconstructionTask &task);
 
-  void extract_all_cost_plans(SymSolutionCut &sym_cut, bool fw, Plan &plan);
-  void extract_all_zero_plans(SymSolutionCut &sym_cut, bool fw, Plan &plan);
+  std::shared_ptr<ClosedList> get_closed(bool fw) const;
 
-  // Return wether a zero cost reconstruction step was necessary
-  bool reconstruct_zero_action(SymSolutionCut &sym_cut, bool fw,
-                               std::shared_ptr<ClosedList> closed,
-                               const Plan &plan);
-  bool reconstruct_cost_action(SymSolutionCut &sym_cut, bool fw,
-                               std::shared_ptr<ClosedList> closed,
-                               const Plan &plan);
+  // Adds the plan and, if it was not a duplicate, its path cuts as goal
+  // path states
+  void add_plan(const Plan &plan);
 
 public:
   SymSolutionRegistry();
@@ -62,6 +102,11 @@ public:
   void register_solution(const SymSolutionCut &solution);
   void construct_cheaper_solutions(int bound);
 
+  // Checkpoints of the registered cuts and of the unfinished enumeration,
+  // which continues where it stopped once more plans are needed
+  void write(SymCheckpointWriter &writer) const;
+  void read(SymCheckpointReader &reader);
+
   bool found_all_plans() const {
     return plan_data_base && plan_data_base->found_enough_plans();
   }
@@ -4,69 +4,145 @@
 #include "../../plugin.h"
 #include "../../state_registry.h"
 #include "../../tasks/root_task.h"
+#include "../../utils/system.h"
+#include "../sym_checkpoint.h"
 
 namespace symbolic {
 
 void PlanDataBase::add_options_to_parser(options::OptionParser &parser) {
   parser.add_option<int>("num_plans", "number of plans", "infinity",
                          Bounds("1", "infinity"));
+  parser.add_option<std::string>(
+      "plan_stream",
+      "append all plans to this file (- for stdout), one plan per line, "
+      "instead of writing each plan to its own numbered plan file. The "
+      "plans are buffered and written as whole lines, at the latest after "
+      "each search step. If the planner is killed, only the plans of the "
+      "current step are lost and the stream never ends in a partial line",
+      OptionParser::NONE);
 }
 
 PlanDataBase::PlanDataBase(const options::Options &opts)
     : sym_vars(nullptr), anytime_completness(false),
       num_desired_plans(opts.get<int>("num_plans")), num_accepted_plans(0),
       num_rejected_plans(0),
-      first_accepted_plan_cost(std::numeric_limits<double>::infinity()) {}
+      first_accepted_plan_cost(std::numeric_limits<double>::infinity()),
+      plan_stream(nullptr), num_streamed_plans(0) {
+  if (opts.contains("plan_stream")) {
+    plan_stream_name = opts.get<std::string>("plan_stream");
+  }
+}
 
 void PlanDataBase::init(std::shared_ptr<SymVariables> sym_vars) {
   this->sym_vars = sym_vars;
   states_accepted_goal_paths = sym_vars->zeroBDD();
+
+  if (plan_stream_name == "-") {
+    plan_stream = &std::cout;
+  } else if (!plan_stream_name.empty()) {
+    plan_stream_file.open(plan_stream_name, std::ofstream::app);
+    if (plan_stream_file.rdstate() & std::ofstream::failbit) {
+      std::cerr << "Failed to open plan stream: " << plan_stream_name
+                << std::endl;
+      utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+    }
+    plan_stream = &plan_stream_file;
+  }
 }
 
-bool PlanDataBase::has_accepted_plan(const Plan &plan) const {
-  size_t plan_seed = get_hash_value(plan);
-  if (hashes_accepted_plans.count(plan_seed) == 0) {
-    return false;
+void PlanDataBase::write_plan(const Plan &plan) {
+  const TaskProxy &task_proxy =
+      sym_vars->get_state_registry()->get_task_proxy();
+  if (!plan_stream) {
+    plan_mgr.save_plan(plan, task_proxy, false, true);
+    return;
+  }
+  OperatorsProxy operators = task_proxy.get_operators();
+  for (OperatorID op_id : plan) {
+    plan_stream_buffer += "(" + operators[op_id].get_name() + ") ";
   }
-  if (different(hashes_accepted_plans.at(plan_seed), plan)) {
-    return false;
+  plan_stream_buffer += "; cost = " +
+                        std::to_string(calculate_plan_cost(plan, task_proxy)) +
+                        "\n";
+  ++num_streamed_plans;
+  if (plan_stream_buffer.size() >= PLAN_STREAM_BUFFER_SIZE) {
+    flush_plans();
   }
-  return true;
 }
 
-bool PlanDataBase::has_rejected_plan(const Plan &plan) const {
-  size_t plan_seed = get_hash_value(plan);
-  if (hashes_rejected_plans.count(plan_seed) == 0) {
-    return false;
+void PlanDataBase::flush_plans() {
+  if (plan_stream) {
+    // Only whole lines are buffered, so the stream never ends in a partial
+    // line if the planner is killed
+    plan_stream->write(plan_stream_buffer.data(), plan_stream_buffer.size());
+    plan_stream->flush();
+    plan_stream_buffer.clear();
+  }
+}
+
+void PlanDataBase::write(SymCheckpointWriter &writer) const {
+  writer.write(tag());
+  writer.write(num_accepted_plans);
+  writer.write(num_rejected_plans);
+  for (const PlanTrie *plans : {&accepted_plans, &rejected_plans}) {
+    std::vector<Plan> all_plans = plans->get_plans();
+    writer.write(static_cast<int>(all_plans.size()));
+    for (const Plan &plan : all_plans) {
+      writer.write(plan);
+    }
+  }
+  writer.write(first_accepted_plan);
+  writer.write(first_accepted_plan_cost);
+  writer.write(states_accepted_goal_paths);
+  writer.write(get_num_reported_plan());
+}
+
+void PlanDataBase::read(SymCheckpointReader &reader) {
+  std::string saved_tag;
+  reader.read(saved_tag);
+  if (saved_tag != tag()) {
+    reader.exit_with_error("the plans were selected by " + saved_tag);
+  }
+  reader.read(num_accepted_plans);
+  reader.read(num_rejected_plans);
+  accepted_plans = PlanTrie();
+  rejected_plans = PlanTrie();
+  for (PlanTrie *plans : {&accepted_plans, &rejected_plans}) {
+    int num_plans = 0;
+    reader.read(num_plans);
+    for (int i = 0; i < num_plans; ++i) {
+      Plan plan;
+      reader.read(plan);
+      plans->insert(plan);
+    }
   }
-  if (different(hashes_rejected_plans.at(plan_seed), plan)) {
-    return false;
+  reader.read(first_accepted_plan);
+  reader.read(first_accepted_plan_cost);
+  reader.read(states_accepted_goal_paths);
+  int num_reported_plans = 0;
+  reader.read(num_reported_plans);
+  if (plan_stream) {
+    num_streamed_plans = num_reported_plans;
+  } else {
+    plan_mgr.set_num_previously_generated_plans(num_reported_plans);
   }
-  return true;
+}
+
+bool PlanDataBase::has_accepted_plan(const Plan &plan) const {
+  return accepted_plans.contains(plan);
+}
+
+bool PlanDataBase::has_rejected_plan(const Plan &plan) const {
+  return rejected_plans.contains(plan);
 }
 
 void PlanDataBase::print_options() const {
   std::cout << "Plan Selector: " << tag() << std::endl;
-  std::cout << "Plan files: " << plan_mgr.get_plan_filename() << std::endl;
-}
-
-size_t PlanDataBase::different(const std::vector<Plan> &plans,
-                               const Plan &plan) const {
-  for (auto &cur : plans) {
-    if (cur.size() == plan.size()) {
-      bool same = true;
-      for (size_t i = 0; i < cur.size(); ++i) {
-        if (cur.at(i) != plan.at(i)) {
-          same = false;
-          break;
-        }
-      }
-      if (same) {
-        return false;
-      }
-    }
+  if (plan_stream_name.empty()) {
+    std::cout << "Plan files: " << plan_mgr.get_plan_filename() << std::endl;
+  } else {
+    std::cout << "Plan stream: " << plan_stream_name << std::endl;
   }
-  return true;
 }
 
 BDD PlanDataBase::states_on_path(const Plan &plan) {
@@ -81,19 +157,6 @@ BDD PlanDataBase::states_on_path(const Plan &plan) {
   return path_states;
 }
 
-// Hashes a vector of ints (= a plan)
-// According to the following link this is the has function used by boost
-// for hashing vector<int>. Experience: really good function
-// https://stackoverflow.com/questions/20511347/a-good-hash-function-for-a-vector
-
-size_t PlanDataBase::get_hash_value(const Plan &plan) const {
-  std::size_t seed = plan.size();
-  for (auto &op : plan) {
-    seed ^= op.get_index() + 0x9e3779b9 + (seed << 6) + (seed >> 2);
-  }
-  return seed;
-}
-
 void PlanDataBase::save_accepted_plan(const Plan &plan) {
   if (num_accepted_plans == 0) {
     first_accepted_plan = plan;
@@ -101,24 +164,13 @@ void PlanDataBase::save_accepted_plan(const Plan &plan) {
         plan, sym_vars->get_state_registry()->get_task_proxy());
   }
 
-  size_t plan_seed = get_hash_value(plan);
-  if (hashes_accepted_plans.count(plan_seed) == 0) {
-    hashes_accepted_plans[plan_seed] = std::vector<Plan>();
-  }
-  hashes_accepted_plans[plan_seed].push_back(plan);
-  states_accepted_goal_paths += states_on_path(plan);
+  accepted_plans.insert(plan);
   num_accepted_plans++;
-  plan_mgr.save_plan(plan, sym_vars->get_state_registry()->get_task_proxy(),
-                     false, true);
+  write_plan(plan);
 }
 
 void PlanDataBase::save_rejected_plan(const Plan &plan) {
-  size_t plan_seed = get_hash_value(plan);
-  if (hashes_rejected_plans.count(plan_seed) == 0) {
-    hashes_rejected_plans[plan_seed] = std::vector<Plan>();
-  }
-  hashes_rejected_plans[plan_seed].push_back(plan);
-  states_accepted_goal_paths += states_on_path(plan);
+  rejected_plans.insert(plan);
   num_rejected_plans++;
 }
 
@@ -189,11 +241,7 @@ PlanDataBase::get_first_zero_cost_loop(const Plan &plan) const {
 }
 
 std::vector<Plan> PlanDataBase::get_accepted_plans() const {
-  std::vector<Plan> res;
-  for (auto &it : hashes_accepted_plans) {
-    res.insert(res.end(), it.second.begin(), it.second.end());
-  }
-  return res;
+  return accepted_plans.get_plans();
 }
 
 static PluginTypePlugin<PlanDataBase> _type_plugin("PlanDataBase", "");
@@ -4,9 +4,10 @@
 #include "../../plan_manager.h"
 #include "../../plugin.h"
 #include "../sym_variables.h"
+#include "plan_trie.h"
 
+#include <fstream>
 #include <memory>
-#include <unordered_map>
 
 class StateRegistry;
 
@@ -16,6 +17,8 @@ class Options;
 } // namespace options
 
 namespace symbolic {
+class SymCheckpointWriter;
+class SymCheckpointReader;
 
 class PlanDataBase {
 public:
@@ -47,15 +50,34 @@ public:
     return num_accepted_plans >= num_desired_plans;
   }
 
+  // Called by the plan reconstruction with the states on the path of each
+  // accepted or rejected plan
+  void add_states_on_goal_paths(const BDD &states) {
+    states_accepted_goal_paths += states;
+  }
+
   BDD get_states_accepted_goal_path() const {
     return anytime_completness ? states_accepted_goal_paths
                                : sym_vars->oneBDD();
   }
 
   int get_num_reported_plan() const {
-    return plan_mgr.get_num_previously_generated_plans();
+    return plan_stream ? num_streamed_plans
+                       : plan_mgr.get_num_previously_generated_plans();
   }
 
+  // Writes out the plans that are still buffered for the plan stream.
+  // Called after each step and at the end of the search.
+  void flush_plans();
+
+  /*
+   * Checkpoints of the found plans. After read(), the numbering of the plan
+   * files continues after the plans of the checkpoint, which are not
+   * reported again. The number of desired plans is kept.
+   */
+  void write(SymCheckpointWriter &writer) const;
+  void read(SymCheckpointReader &reader);
+
   void dump_first_accepted_plan() const {
     plan_mgr.dump_plan(first_accepted_plan,
                        sym_vars->get_state_registry()->get_task_proxy());
@@ -86,8 +108,8 @@ protected:
   int num_accepted_plans;
   int num_rejected_plans;
 
-  std::unordered_map<size_t, std::vector<Plan>> hashes_accepted_plans;
-  std::unordered_map<size_t, std::vector<Plan>> hashes_rejected_plans;
+  PlanTrie accepted_plans;
+  PlanTrie rejected_plans;
 
   Plan first_accepted_plan;
   double first_accepted_plan_cost;
@@ -96,15 +118,28 @@ protected:
 
   PlanManager plan_mgr;
   bool task_hash_zero_cost_actions;
-  
+
+  // If set, all plans are written to this stream, one plan per line,
+  // instead of one file per plan. Complete lines are collected in the
+  // buffer, which is written out once it holds PLAN_STREAM_BUFFER_SIZE
+  // bytes or when flush_plans() is called.
+  static const size_t PLAN_STREAM_BUFFER_SIZE = 1 << 20;
+  std::string plan_stream_name;
+  std::ostream *plan_stream;
+  std::ofstream plan_stream_file;
+  std::string plan_stream_buffer;
+  int num_streamed_plans;
+
+  // Reports the plan in a plan file or in the plan stream
+  void write_plan(const Plan &plan);
+
   void save_accepted_plan(const Plan &plan);
   void save_rejected_plan(const Plan &plan);
 
   std::vector<Plan> get_accepted_plans() const;
 
-  size_t different(const std::vector<Plan> &plans, const Plan &plan) const;
+  // Explicit states of the plan, for selectors that need concrete states
   BDD states_on_path(const Plan &plan);
-  size_t get_hash_value(const Plan &plan) const;
 };
 
 } // namespace symbolic
@@ -0,0 +1,73 @@
+#include "plan_trie.h"
+
+using namespace std;
+
+namespace symbolic {
+
+PlanTrie::PlanTrie() : plan_ends(1, false), num_plans(0) {}
+
+int PlanTrie::find_node(const Plan &plan) const {
+  int node = 0;
+  for (OperatorID op : plan) {
+    auto it = children.find(get_key(node, op));
+    if (it == children.end()) {
+      return -1;
+    }
+    node = it->second;
+  }
+  return node;
+}
+
+bool PlanTrie::contains(const Plan &plan) const {
+  int node = find_node(plan);
+  return node != -1 && plan_ends[node];
+}
+
+bool PlanTrie::insert(const Plan &plan) {
+  int node = 0;
+  for (OperatorID op : plan) {
+    auto res = children.emplace(get_key(node, op), plan_ends.size());
+    if (res.second) {
+      plan_ends.push_back(false);
+    }
+    node = res.first->second;
+  }
+  if (plan_ends[node]) {
+    return false;
+  }
+  plan_ends[node] = true;
+  num_plans++;
+  return true;
+}
+
+void PlanTrie::collect_plans(
+    int node, Plan &prefix,
+    const unordered_map<int, vector<pair<OperatorID, int>>> &node_children,
+    vector<Plan> &plans) const {
+  if (plan_ends[node]) {
+    plans.push_back(prefix);
+  }
+  auto it = node_children.find(node);
+  if (it == node_children.end()) {
+    return;
+  }
+  for (const auto &child : it->second) {
+    prefix.push_back(child.first);
+    collect_plans(child.second, prefix, node_children, plans);
+    prefix.pop_back();
+  }
+}
+
+vector<Plan> PlanTrie::get_plans() const {
+  unordered_map<int, vector<pair<OperatorID, int>>> node_children;
+  for (const auto &edge : children) {
+    int node = edge.first >> 32;
+    OperatorID op(static_cast<uint32_t>(edge.first));
+    node_children[node].emplace_back(op, edge.second);
+  }
+  vector<Plan> plans;
+  Plan prefix;
+  collect_plans(0, prefix, node_children, plans);
+  return plans;
+}
+} // namespace symbolic
@@ -0,0 +1,53 @@
+#ifndef SYMBOLIC_PLAN_TRIE_H
+#define SYMBOLIC_PLAN_TRIE_H
+
+#include "../../operator_id.h"
+#include "../../plan_manager.h"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace symbolic {
+
+/*
+ * Set of plans stored as a trie over operator ids. Plans with a common
+ * prefix share its nodes, and membership tests take O(plan length). The
+ * edges of all nodes are kept in one hash table keyed by (node, operator),
+ * so that a node needs no storage besides its end-of-plan flag.
+ */
+class PlanTrie {
+  std::unordered_map<uint64_t, int> children;
+  std::vector<bool> plan_ends; // One entry per node, the root is node 0
+  int num_plans;
+
+  static uint64_t get_key(int node, OperatorID op) {
+    return (static_cast<uint64_t>(node) << 32) |
+           static_cast<uint32_t>(op.get_index());
+  }
+
+  // Returns -1 if the plan leaves the trie
+  int find_node(const Plan &plan) const;
+
+  void collect_plans(int node, Plan &prefix,
+                     const std::unordered_map<int, std::vector<std::pair<
+                         OperatorID, int>>> &node_children,
+                     std::vector<Plan> &plans) const;
+
+public:
+  PlanTrie();
+
+  bool contains(const Plan &plan) const;
+
+  // Returns false if the plan was already contained
+  bool insert(const Plan &plan);
+
+  int size() const { return num_plans; }
+
+  int get_num_nodes() const { return plan_ends.size(); }
+
+  std::vector<Plan> get_plans() const;
+};
+} // namespace symbolic
+
+#endif
@@ -30,16 +30,9 @@ namespace symbolic
           ordered_plan, sym_vars->get_state_registry()->get_task_proxy());
     }
 
-    size_t plan_seed = get_hash_value(unordered_plan);
-    if (hashes_accepted_plans.count(plan_seed) == 0)
-    {
-      hashes_accepted_plans[plan_seed] = std::vector<Plan>();
-    }
-    hashes_accepted_plans[plan_seed].push_back(unordered_plan);
-    states_accepted_goal_paths += states_on_path(ordered_plan);
+    accepted_plans.insert(unordered_plan);
     num_accepted_plans++;
-    plan_mgr.save_plan(ordered_plan, sym_vars->get_state_registry()->get_task_proxy(),
-                       false, true);
+    write_plan(ordered_plan);
   }
 
   static std::shared_ptr<PlanDataBase> _parse(OptionParser &parser)
@@ -0,0 +1,131 @@
+#include "plan_counting_symbolic_search.h"
+#include "../../option_parser.h"
+#include "../closed_list.h"
+#include "../plan_reconstruction/plan_counter.h"
+#include "../plugin.h"
+#include "../searches/uniform_cost_search.h"
+#include "../sym_state_space_manager.h"
+
+#include <limits>
+#include <memory>
+
+namespace symbolic {
+
+PlanCountingSymbolicSearch::PlanCountingSymbolicSearch(
+    const options::Options &opts)
+    : TopkSymbolicUniformCostSearch(opts, true, false), next_cost(0),
+      goal_path_states_computed(false), cost_bound(opts.get<int>("bound")),
+      only_optimal(opts.get<bool>("only_optimal")) {}
+
+PlanCountingSymbolicSearch::~PlanCountingSymbolicSearch() {}
+
+void PlanCountingSymbolicSearch::initialize() {
+  TopkSymbolicUniformCostSearch::initialize();
+  closed = static_cast<UniformCostSearch *>(search.get())->getClosedShared();
+  plan_counter = std::unique_ptr<PlanCounter>(
+      new PlanCounter(vars.get(), mgr->getIndividualTRs(), closed,
+                      mgr->getInitialState(), mgr->getGoal()));
+}
+
+BDD PlanCountingSymbolicSearch::get_states_on_goal_paths() const {
+  if (!goal_path_states_computed) {
+    // Backward search from the goal without cost layers
+    int max_nodes = std::numeric_limits<int>::max();
+    goal_path_states = mgr->getGoal();
+    BDD new_states = goal_path_states;
+    while (!new_states.IsZero()) {
+      std::vector<BDD> preimages;
+      if (mgr->hasTransitions0()) {
+        mgr->zero_image(false, new_states, preimages, max_nodes);
+      }
+      std::map<int, std::vector<BDD>> cost_preimages;
+      mgr->cost_image(false, new_states, cost_preimages, max_nodes);
+      for (const auto &cost_bdds : cost_preimages) {
+        preimages.insert(preimages.end(), cost_bdds.second.begin(),
+                         cost_bdds.second.end());
+      }
+      new_states = vars->zeroBDD();
+      for (const BDD &preimage : preimages) {
+        new_states += preimage;
+      }
+      new_states = mgr->filter_mutex(new_states * !goal_path_states, false,
+                                     max_nodes, false);
+      goal_path_states += new_states;
+    }
+    goal_path_states_computed = true;
+  }
+  return goal_path_states;
+}
+
+bool PlanCountingSymbolicSearch::count_plans(int below_cost) {
+  for (; next_cost < below_cost && next_cost <= cost_bound; ++next_cost) {
+    PlanCount num_plans = plan_counter->count_plans(next_cost);
+    if (num_plans.is_zero()) {
+      continue;
+    }
+    std::cout << "Number of plans of cost " << next_cost << ": "
+              << num_plans.to_string() << std::endl;
+    solution_found = true;
+    if (num_plans.is_infinite() || only_optimal) {
+      return false;
+    }
+  }
+  return next_cost <= cost_bound;
+}
+
+SearchStatus PlanCountingSymbolicSearch::step() {
+  step_num++;
+  if (lower_bound_increased) {
+    std::cout << "BOUND: " << lower_bound << ", total time: " << utils::g_timer
+              << std::endl;
+    lower_bound_increased = false;
+  }
+
+  // Closed layers below the minimum g of the open list are complete
+  int complete_cost = min_g;
+  bool search_finished = lower_bound == std::numeric_limits<int>::max();
+  if (search_finished) {
+    // Nothing more can be reached
+    std::map<int, BDD> closed_layers = closed->getClosedList();
+    complete_cost =
+        closed_layers.empty() ? 0 : closed_layers.rbegin()->first + 1;
+  }
+  if (!count_plans(complete_cost) || search_finished) {
+    return solution_found ? SOLVED : FAILED;
+  }
+
+  search->step();
+  return IN_PROGRESS;
+}
+
+void PlanCountingSymbolicSearch::add_options_to_parser(OptionParser &parser) {
+  parser.add_option<int>("bound", "count the plans up to this cost",
+                         "infinity", Bounds("0", "infinity"));
+  parser.add_option<bool>(
+      "only_optimal", "stop after counting the plans of the cheapest cost",
+      "true");
+}
+
+} // namespace symbolic
+
+static std::shared_ptr<SearchEngine> _parse(OptionParser &parser) {
+  parser.document_synopsis("Symbolic Forward Plan Counting",
+                           "Counts the plans of each cost with a top-k "
+                           "forward search without reconstructing them.");
+  symbolic::SymbolicSearch::add_options_to_parser(parser);
+  parser.add_option<std::shared_ptr<symbolic::PlanDataBase>>(
+      "plan_selection", "plan selection strategy (not used)",
+      "top_k(num_plans=infinity)");
+  symbolic::PlanCountingSymbolicSearch::add_options_to_parser(parser);
+  Options opts = parser.parse();
+
+  std::shared_ptr<symbolic::SymbolicSearch> engine = nullptr;
+  if (!parser.dry_run()) {
+    engine = std::make_shared<symbolic::PlanCountingSymbolicSearch>(opts);
+    std::cout << "Symbolic Forward Plan Counting" << std::endl;
+  }
+
+  return engine;
+}
+
+static Plugin<SearchEngine> _plugin("symk-count", _parse);
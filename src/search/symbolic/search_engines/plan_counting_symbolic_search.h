@@ -0,0 +1,49 @@
+#ifndef SYMBOLIC_SEARCH_ENGINES_PLAN_COUNTING_SYMBOLIC_SEARCH_H
+#define SYMBOLIC_SEARCH_ENGINES_PLAN_COUNTING_SYMBOLIC_SEARCH_H
+
+#include "top_k_symbolic_uniform_cost_search.h"
+
+namespace symbolic {
+class ClosedList;
+class PlanCounter;
+
+// Top-k forward search that counts the plans of each cost instead of
+// reconstructing them
+class PlanCountingSymbolicSearch : public TopkSymbolicUniformCostSearch {
+private:
+  std::shared_ptr<ClosedList> closed; // Of the forward search
+  std::unique_ptr<PlanCounter> plan_counter;
+  int next_cost; // Cheapest cost whose plans have not been counted yet
+
+  // States from which a goal state can be reached, computed on first use
+  mutable BDD goal_path_states;
+  mutable bool goal_path_states_computed;
+
+  // Reports the number of plans of all costs below the given one
+  // Returns false if no more plans should be counted
+  bool count_plans(int below_cost);
+
+protected:
+  int cost_bound;    // Count the plans up to this cost
+  bool only_optimal; // Stop after the cheapest plans
+
+  virtual void initialize() override;
+
+  virtual SearchStatus step() override;
+
+public:
+  PlanCountingSymbolicSearch(const options::Options &opts);
+  virtual ~PlanCountingSymbolicSearch();
+
+  // Plans of higher costs can only visit states from which a goal state
+  // can be reached, so the search ends once no such state is expanded again
+  virtual BDD get_states_on_goal_paths() const override;
+
+  virtual void new_solution(const SymSolutionCut &) override {}
+
+  static void add_options_to_parser(OptionParser &parser);
+};
+
+} // namespace symbolic
+
+#endif
@@ -21,16 +21,21 @@ using namespace options;
 
 namespace symbolic {
 
-SymbolicSearch::SymbolicSearch(const options::Options &opts)
+SymbolicSearch::SymbolicSearch(const options::Options &opts,
+                               int num_extra_managers)
     : SearchEngine(opts), vars(make_shared<SymVariables>(opts)),
       mgrParams(opts), searchParams(opts), step_num(-1),
       lower_bound_increased(true), lower_bound(0),
       upper_bound(std::numeric_limits<int>::max()), min_g(0),
       plan_data_base(opts.get<std::shared_ptr<PlanDataBase>>("plan_selection")),
-      solution_registry() {
+      solution_registry(), image_threads(opts.get<int>("image_threads")),
+      vars_opts(opts),
+      num_managers(1 + (image_threads > 1 ? image_threads : 0) +
+                   num_extra_managers) {
   save_plans = false;
   mgrParams.print_options();
   searchParams.print_options();
+  vars->split_memory(num_managers);
   vars->init();
 }
 
@@ -39,6 +44,20 @@ void SymbolicSearch::initialize() {
   plan_data_base->print_options();
 }
 
+void SymbolicSearch::init_parallel_image() {
+  if (image_threads > 1) {
+    vector<shared_ptr<SymVariables>> image_vars;
+    for (int i = 0; i < image_threads; ++i) {
+      image_vars.push_back(make_shared<SymVariables>(vars_opts));
+      image_vars.back()->split_memory(num_managers);
+      image_vars.back()->init(vars->get_var_order());
+    }
+    mgr->init_parallel_image(image_vars);
+    std::cout << "Computing images on " << image_threads << " threads"
+              << std::endl;
+  }
+}
+
 SearchStatus SymbolicSearch::step() {
   step_num++;
   // Handling empty plan
@@ -111,11 +130,25 @@ void SymbolicSearch::new_solution(const SymSolutionCut &sol) {
   }
 }
 
+void SymbolicSearch::save_plan_if_necessary() {
+  plan_data_base->flush_plans();
+}
+
+void SymbolicSearch::print_statistics() const {
+  SearchEngine::print_statistics();
+  vars->print_statistics();
+}
+
 void SymbolicSearch::add_options_to_parser(OptionParser &parser) {
   SearchEngine::add_options_to_parser(parser);
   SymVariables::add_options_to_parser(parser);
   SymParamsSearch::add_options_to_parser(parser, 30e3, 10e7);
   SymParamsMgr::add_options_to_parser(parser);
   PlanDataBase::add_options_to_parser(parser);
+  parser.add_option<int>(
+      "image_threads",
+      "number of threads that compute each image, each with its own CUDD "
+      "manager and a share of the transition relations",
+      "1", Bounds("1", "infinity"));
 }
 } // namespace symbolic
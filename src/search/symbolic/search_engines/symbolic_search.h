@@ -42,13 +42,24 @@ protected:
 
   std::shared_ptr<PlanDataBase> plan_data_base;
   SymSolutionRegistry solution_registry; // Solution registry
+
+  // Number of threads that compute each image, each with its own manager.
+  // The managers are created with vars_opts once the TRs exist.
+  int image_threads;
+  options::Options vars_opts;
+  // Number of CUDD managers that share the memory
+  int num_managers;
   
   virtual void initialize() override;
 
+  // Must be called once mgr is created to compute images on several threads
+  void init_parallel_image();
+
   virtual SearchStatus step() override;
 
 public:
-  SymbolicSearch(const options::Options &opts);
+  // Derived engines may use num_extra_managers more CUDD managers
+  SymbolicSearch(const options::Options &opts, int num_extra_managers = 0);
   virtual ~SymbolicSearch() = default;
 
   virtual void setLowerBound(int lower);
@@ -67,6 +78,11 @@ public:
 
   virtual void new_solution(const SymSolutionCut &sol);
 
+  virtual void print_statistics() const override;
+
+  // The plans are saved as they are found, this only flushes the plan stream
+  virtual void save_plan_if_necessary() override;
+
   static void add_options_to_parser(OptionParser &parser);
 };
 
@@ -1,5 +1,8 @@
 #include "symbolic_uniform_cost_search.h"
 #include "../../option_parser.h"
+#include "../../pdbs/pattern_generator.h"
+#include "../../pdbs/spdb.h"
+#include "../../utils/logging.h"
 #include "../original_state_space.h"
 #include "../plugin.h"
 #include "../searches/bidirectional_search.h"
@@ -11,7 +14,10 @@ namespace symbolic {
 
 void SymbolicUniformCostSearch::initialize() {
   SymbolicSearch::initialize();
-  mgr = std::make_shared<OriginalStateSpace>(vars.get(), mgrParams);
+  auto original_mgr =
+      std::make_shared<OriginalStateSpace>(vars.get(), mgrParams);
+  mgr = original_mgr;
+  init_parallel_image();
 
   std::unique_ptr<UniformCostSearch> fw_search = nullptr;
   std::unique_ptr<UniformCostSearch> bw_search = nullptr;
@@ -19,6 +25,9 @@ void SymbolicUniformCostSearch::initialize() {
   if (fw) {
     fw_search = std::unique_ptr<UniformCostSearch>(
         new UniformCostSearch(this, searchParams));
+    if (heuristic_pattern) {
+      fw_search->set_heuristic(compute_heuristic_layers());
+    }
   }
 
   if (bw) {
@@ -40,15 +49,56 @@ void SymbolicUniformCostSearch::initialize() {
 
   if (fw && bw) {
     search = std::unique_ptr<BidirectionalSearch>(new BidirectionalSearch(
-        this, searchParams, move(fw_search), move(bw_search)));
+        this, searchParams, move(fw_search), move(bw_search),
+        init_bw_image_mgr(*original_mgr)));
   } else {
     search.reset(fw ? fw_search.release() : bw_search.release());
   }
 }
 
+std::vector<BDD> SymbolicUniformCostSearch::compute_heuristic_layers() {
+  pdbs::Pattern pattern = heuristic_pattern->generate(task);
+  spdb_params.print_options();
+  pdbs::SPDB spdb(vars, task_proxy, pattern, true, std::vector<int>(),
+                  spdb_params);
+  std::cout << "BDDA* heuristic: SPDB with pattern " << pattern
+            << ", initial h value: " << spdb.initialHVal << std::endl;
+  return spdb.get_layers();
+}
+
 SymbolicUniformCostSearch::SymbolicUniformCostSearch(
     const options::Options &opts, bool fw, bool bw)
-    : SymbolicSearch(opts), fw(fw), bw(bw) {}
+    : SymbolicSearch(opts, uses_parallel_directions(opts)), fw(fw), bw(bw),
+      parallel_directions(uses_parallel_directions(opts)) {
+  if (opts.contains("spdb_pattern")) {
+    heuristic_pattern =
+        opts.get<std::shared_ptr<pdbs::PatternGenerator>>("spdb_pattern");
+    spdb_params.max_tr_size = mgrParams.max_tr_size;
+    spdb_params.max_tr_time = mgrParams.max_tr_time;
+    spdb_params.max_nodes = opts.get<int>("spdb_max_nodes");
+    spdb_params.max_time = opts.get<int>("spdb_max_time");
+  }
+}
+
+SymStateSpaceManager *SymbolicUniformCostSearch::init_bw_image_mgr(
+    const OriginalStateSpace &original_mgr) {
+  if (!parallel_directions) {
+    return nullptr;
+  }
+  // Same BDD variables as vars, so that BDDs can be transferred
+  bw_image_vars = std::make_shared<SymVariables>(vars_opts);
+  bw_image_vars->split_memory(num_managers);
+  bw_image_vars->init(vars->get_var_order());
+  bw_image_mgr =
+      std::make_shared<OriginalStateSpace>(bw_image_vars.get(), original_mgr);
+  return bw_image_mgr.get();
+}
+
+bool SymbolicUniformCostSearch::uses_parallel_directions(
+    const options::Options &opts) {
+  return opts.contains("parallel_directions") &&
+         opts.get<bool>("parallel_directions");
+}
 
 void SymbolicUniformCostSearch::new_solution(const SymSolutionCut &sol) {
   if (!solution_registry.found_all_plans() && sol.get_f() < upper_bound) {
@@ -57,13 +107,41 @@ void SymbolicUniformCostSearch::new_solution(const SymSolutionCut &sol) {
   }
 }
 
+void SymbolicUniformCostSearch::add_parallel_directions_option_to_parser(
+    options::OptionParser &parser) {
+  parser.add_option<bool>(
+      "parallel_directions",
+      "compute the forward and the backward image of a step at the same "
+      "time on two threads; the backward images use a second CUDD manager "
+      "and are copied into the main one",
+      "false");
+}
+
 } // namespace symbolic
 
 static std::shared_ptr<SearchEngine> _parse_forward_ucs(OptionParser &parser) {
-  parser.document_synopsis("Symbolic Forward Uniform Cost Search", "");
+  parser.document_synopsis(
+      "Symbolic Forward Uniform Cost Search",
+      "If spdb_pattern is given, the search is a BDDA* that orders the "
+      "open states by g + h, where h is a symbolic PDB for the pattern. "
+      "Each generated BDD is split into one BDD per h value, no states "
+      "are enumerated.");
   symbolic::SymbolicSearch::add_options_to_parser(parser);
   parser.add_option<std::shared_ptr<symbolic::PlanDataBase>>(
       "plan_selection", "plan selection strategy", "top_k(num_plans=1)");
+  parser.add_option<std::shared_ptr<pdbs::PatternGenerator>>(
+      "spdb_pattern", "pattern of the SPDB heuristic guiding the search",
+      OptionParser::NONE);
+  parser.add_option<int>(
+      "spdb_max_nodes",
+      "maximum size of each image BDD while building the SPDB; when "
+      "exceeded, the SPDB is truncated",
+      "infinity", options::Bounds("1", "infinity"));
+  parser.add_option<int>(
+      "spdb_max_time",
+      "maximum time (ms) to build the SPDB; when exceeded, the SPDB is "
+      "truncated",
+      "infinity", options::Bounds("0", "infinity"));
   Options opts = parser.parse();
 
   std::shared_ptr<symbolic::SymbolicSearch> engine = nullptr;
@@ -99,6 +177,8 @@ _parse_bidirectional_ucs(OptionParser &parser) {
   symbolic::SymbolicSearch::add_options_to_parser(parser);
   parser.add_option<std::shared_ptr<symbolic::PlanDataBase>>(
       "plan_selection", "plan selection strategy", "top_k(num_plans=1)");
+  symbolic::SymbolicUniformCostSearch::add_parallel_directions_option_to_parser(
+      parser);
   Options opts = parser.parse();
 
   std::shared_ptr<symbolic::SymbolicSearch> engine = nullptr;
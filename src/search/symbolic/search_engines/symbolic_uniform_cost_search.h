@@ -3,15 +3,47 @@
 
 #include "symbolic_search.h"
 
+#include "../../pdbs/spdb_params.h"
+
+namespace pdbs {
+class PatternGenerator;
+}
+
+namespace options {
+class OptionParser;
+}
+
 namespace symbolic {
+class OriginalStateSpace;
+
 class SymbolicUniformCostSearch : public SymbolicSearch {
 
 protected:
   bool fw;
   bool bw;
 
+  // Pattern of the SPDB that guides the forward search (BDDA*), if any
+  std::shared_ptr<pdbs::PatternGenerator> heuristic_pattern;
+  pdbs::SPDBParams spdb_params;
+
+  // Second CUDD manager to compute the backward images of a bidirectional
+  // search on another thread, if enabled. It gets a copy of the TRs.
+  bool parallel_directions;
+  std::shared_ptr<SymVariables> bw_image_vars;
+  std::shared_ptr<SymStateSpaceManager> bw_image_mgr;
+
+  static bool uses_parallel_directions(const options::Options &opts);
+
+  // Creates the backward image manager from a copy of the TRs of
+  // original_mgr if parallel_directions is set. Returns it or nullptr.
+  SymStateSpaceManager *
+  init_bw_image_mgr(const OriginalStateSpace &original_mgr);
+
   virtual void initialize() override;
 
+  // Builds the SPDB and returns its layers, layer h has value h
+  std::vector<BDD> compute_heuristic_layers();
+
   virtual SearchStatus step() override { return SymbolicSearch::step(); }
 
 public:
@@ -19,6 +51,10 @@ public:
   virtual ~SymbolicUniformCostSearch() = default;
 
   virtual void new_solution(const SymSolutionCut &sol) override;
+
+  // Option of the bidirectional searches
+  static void
+  add_parallel_directions_option_to_parser(options::OptionParser &parser);
 };
 
 } // namespace symbolic
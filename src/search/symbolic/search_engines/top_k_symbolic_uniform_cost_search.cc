@@ -4,6 +4,7 @@
 #include "../plugin.h"
 #include "../searches/bidirectional_search.h"
 #include "../searches/top_k_uniform_cost_search.h"
+#include "../sym_checkpoint.h"
 
 #include <memory>
 
@@ -12,7 +13,10 @@ namespace symbolic {
 void TopkSymbolicUniformCostSearch::initialize() {
   SymbolicSearch::initialize();
 
-  mgr = std::make_shared<OriginalStateSpace>(vars.get(), mgrParams);
+  auto original_mgr =
+      std::make_shared<OriginalStateSpace>(vars.get(), mgrParams);
+  mgr = original_mgr;
+  init_parallel_image();
 
   std::unique_ptr<TopkUniformCostSearch> fw_search = nullptr;
   std::unique_ptr<TopkUniformCostSearch> bw_search = nullptr;
@@ -41,15 +45,63 @@ void TopkSymbolicUniformCostSearch::initialize() {
 
   if (fw && bw) {
     search = std::unique_ptr<BidirectionalSearch>(new BidirectionalSearch(
-        this, searchParams, move(fw_search), move(bw_search)));
+        this, searchParams, move(fw_search), move(bw_search),
+        init_bw_image_mgr(*original_mgr)));
   } else {
     search.reset(fw ? fw_search.release() : bw_search.release());
   }
+
+  if (!load_checkpoint_file.empty()) {
+    load_checkpoint();
+  }
+}
+
+void TopkSymbolicUniformCostSearch::save_checkpoint() const {
+  SymCheckpointWriter writer;
+  writer.write(fw);
+  writer.write(bw);
+  writer.write(step_num);
+  // A lower bound of infinity may only signal that enough plans were found
+  writer.write(std::min(lower_bound, search->getF()));
+  writer.write(min_g);
+  search->write(writer);
+  solution_registry.write(writer);
+  plan_data_base->write(writer);
+  writer.save(save_checkpoint_file, *vars);
+}
+
+void TopkSymbolicUniformCostSearch::load_checkpoint() {
+  SymCheckpointReader reader(load_checkpoint_file, *vars);
+  bool saved_fw = false;
+  bool saved_bw = false;
+  reader.read(saved_fw);
+  reader.read(saved_bw);
+  if (saved_fw != fw || saved_bw != bw) {
+    reader.exit_with_error("the search directions differ");
+  }
+  reader.read(step_num);
+  reader.read(lower_bound);
+  reader.read(min_g);
+  search->read(reader);
+  solution_registry.read(reader);
+  plan_data_base->read(reader);
+  // Continue the enumeration of plans in the first step
+  lower_bound_increased = true;
+  std::cout << "Continuing search from " << load_checkpoint_file << " with "
+            << solution_registry.get_num_found_plans() << " plans"
+            << std::endl;
 }
 
 TopkSymbolicUniformCostSearch::TopkSymbolicUniformCostSearch(
     const options::Options &opts, bool fw, bool bw)
-    : SymbolicUniformCostSearch(opts, fw, bw) {}
+    : SymbolicUniformCostSearch(opts, fw, bw) {
+  if (opts.contains("load_checkpoint")) {
+    load_checkpoint_file = opts.get<std::string>("load_checkpoint");
+  }
+  if (opts.contains("save_checkpoint")) {
+    save_checkpoint_file = opts.get<std::string>("save_checkpoint");
+  }
+}
 
 void TopkSymbolicUniformCostSearch::new_solution(const SymSolutionCut &sol) {
   if (!solution_registry.found_all_plans()) {
@@ -59,6 +111,29 @@ void TopkSymbolicUniformCostSearch::new_solution(const SymSolutionCut &sol) {
   }
 }
 
+void TopkSymbolicUniformCostSearch::save_plan_if_necessary() {
+  SymbolicUniformCostSearch::save_plan_if_necessary();
+  if (!save_checkpoint_file.empty()) {
+    save_checkpoint();
+  }
+}
+
+void TopkSymbolicUniformCostSearch::add_options_to_parser(
+    OptionParser &parser) {
+  parser.add_option<std::string>(
+      "save_checkpoint",
+      "write the open and closed states, the solution cuts and the found "
+      "plans to this file once the search ends (BDDs are stored with "
+      "dddmp)",
+      OptionParser::NONE);
+  parser.add_option<std::string>(
+      "load_checkpoint",
+      "continue the search from a file written with save_checkpoint for "
+      "the same task and search directions, e.g. with more plans or a "
+      "larger quality bound; the plans of that run are not reported again",
+      OptionParser::NONE);
+}
+
 } // namespace symbolic
 
 static std::shared_ptr<SearchEngine> _parse_forward_ucs(OptionParser &parser) {
@@ -66,6 +141,7 @@ static std::shared_ptr<SearchEngine> _parse_forward_ucs(OptionParser &parser) {
   symbolic::SymbolicSearch::add_options_to_parser(parser);
   parser.add_option<std::shared_ptr<symbolic::PlanDataBase>>(
       "plan_selection", "plan selection strategy");
+  symbolic::TopkSymbolicUniformCostSearch::add_options_to_parser(parser);
   Options opts = parser.parse();
 
   std::shared_ptr<symbolic::SymbolicSearch> engine = nullptr;
@@ -83,6 +159,7 @@ static std::shared_ptr<SearchEngine> _parse_backward_ucs(OptionParser &parser) {
   symbolic::SymbolicSearch::add_options_to_parser(parser);
   parser.add_option<std::shared_ptr<symbolic::PlanDataBase>>(
       "plan_selection", "plan selection strategy");
+  symbolic::TopkSymbolicUniformCostSearch::add_options_to_parser(parser);
   Options opts = parser.parse();
 
   std::shared_ptr<symbolic::SymbolicSearch> engine = nullptr;
@@ -102,6 +179,9 @@ _parse_bidirectional_ucs(OptionParser &parser) {
   symbolic::SymbolicSearch::add_options_to_parser(parser);
   parser.add_option<std::shared_ptr<symbolic::PlanDataBase>>(
       "plan_selection", "plan selection strategy");
+  symbolic::TopkSymbolicUniformCostSearch::add_options_to_parser(parser);
+  symbolic::SymbolicUniformCostSearch::add_parallel_directions_option_to_parser(
+      parser);
   Options opts = parser.parse();
 
   std::shared_ptr<symbolic::SymbolicSearch> engine = nullptr;
@@ -7,8 +7,16 @@ namespace symbolic {
 class TopkSymbolicUniformCostSearch : public SymbolicUniformCostSearch {
 
 protected:
+  // Files to continue the search from and to write its state to once the
+  // search ends, empty if not used
+  std::string load_checkpoint_file;
+  std::string save_checkpoint_file;
+
   virtual void initialize() override;
 
+  void save_checkpoint() const;
+  virtual void load_checkpoint();
+
   virtual SearchStatus step() override {
     return SymbolicUniformCostSearch::step();
   }
@@ -18,6 +26,11 @@ public:
   virtual ~TopkSymbolicUniformCostSearch() = default;
 
   virtual void new_solution(const SymSolutionCut &sol) override;
+
+  // Also writes the checkpoint, if requested
+  virtual void save_plan_if_necessary() override;
+
+  static void add_options_to_parser(OptionParser &parser);
 };
 
 } // namespace symbolic
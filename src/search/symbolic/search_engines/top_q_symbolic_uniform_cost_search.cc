@@ -29,6 +29,14 @@ void TopqSymbolicUniformCostSearch::new_solution(const SymSolutionCut &sol) {
   }
 }
 
+void TopqSymbolicUniformCostSearch::load_checkpoint() {
+  TopkSymbolicUniformCostSearch::load_checkpoint();
+  upper_bound = std::numeric_limits<int>::max();
+  if (get_quality_bound() < std::numeric_limits<double>::infinity()) {
+    upper_bound = get_quality_bound() + 1;
+  }
+}
+
 SearchStatus TopqSymbolicUniformCostSearch::step() {
   step_num++;
   // Handling empty plan
@@ -99,6 +107,7 @@ static std::shared_ptr<SearchEngine> _parse_forward_ucs(OptionParser &parser) {
   symbolic::SymbolicSearch::add_options_to_parser(parser);
   parser.add_option<std::shared_ptr<symbolic::PlanDataBase>>(
       "plan_selection", "plan selection strategy");
+  symbolic::TopkSymbolicUniformCostSearch::add_options_to_parser(parser);
   symbolic::TopqSymbolicUniformCostSearch::add_options_to_parser(parser);
   Options opts = parser.parse();
 
@@ -117,6 +126,7 @@ static std::shared_ptr<SearchEngine> _parse_backward_ucs(OptionParser &parser) {
   symbolic::SymbolicSearch::add_options_to_parser(parser);
   parser.add_option<std::shared_ptr<symbolic::PlanDataBase>>(
       "plan_selection", "plan selection strategy");
+  symbolic::TopkSymbolicUniformCostSearch::add_options_to_parser(parser);
   symbolic::TopqSymbolicUniformCostSearch::add_options_to_parser(parser);
   Options opts = parser.parse();
 
@@ -137,7 +147,10 @@ _parse_bidirectional_ucs(OptionParser &parser) {
   symbolic::SymbolicSearch::add_options_to_parser(parser);
   parser.add_option<std::shared_ptr<symbolic::PlanDataBase>>(
       "plan_selection", "plan selection strategy");
+  symbolic::TopkSymbolicUniformCostSearch::add_options_to_parser(parser);
   symbolic::TopqSymbolicUniformCostSearch::add_options_to_parser(parser);
+  symbolic::SymbolicUniformCostSearch::add_parallel_directions_option_to_parser(
+      parser);
   Options opts = parser.parse();
 
   std::shared_ptr<symbolic::SymbolicSearch> engine = nullptr;
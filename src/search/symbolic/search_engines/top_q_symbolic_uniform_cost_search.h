@@ -18,6 +18,9 @@ protected:
 
   virtual SearchStatus step() override;
 
+  // The quality bound is computed with the current quality multiplier
+  virtual void load_checkpoint() override;
+
 public:
   TopqSymbolicUniformCostSearch(const options::Options &opts, bool fw, bool bw);
   virtual ~TopqSymbolicUniformCostSearch() = default;
@@ -11,8 +11,10 @@ namespace symbolic {
 BidirectionalSearch::BidirectionalSearch(SymbolicSearch *eng,
                                          const SymParamsSearch &params,
                                          std::unique_ptr<UniformCostSearch> _fw,
-                                         unique_ptr<UniformCostSearch> _bw)
-    : SymSearch(eng, params), fw(std::move(_fw)), bw(std::move(_bw)) {
+                                         unique_ptr<UniformCostSearch> _bw,
+                                         SymStateSpaceManager *bw_image_mgr)
+    : SymSearch(eng, params), fw(std::move(_fw)), bw(std::move(_bw)),
+      bw_image_mgr(bw_image_mgr) {
 
   assert(fw->getStateSpace() == bw->getStateSpace());
   mgr = fw->getStateSpaceShared();
@@ -37,7 +39,14 @@ bool BidirectionalSearch::finished() const {
 }
 
 bool BidirectionalSearch::stepImage(int maxTime, int maxNodes) {
-  bool res = selectBestDirection()->stepImage(maxTime, maxNodes);
+  bool res;
+  if (bw_image_mgr && fw->isSearchableWithNodes(maxNodes) &&
+      bw->isSearchableWithNodes(maxNodes)) {
+    res = UniformCostSearch::stepImageParallel(*fw, *bw, bw_image_mgr, maxTime,
+                                               maxNodes);
+  } else {
+    res = selectBestDirection()->stepImage(maxTime, maxNodes);
+  }
   engine->setLowerBound(getF());
   engine->setMinG(fw->getG() + bw->getG());
 
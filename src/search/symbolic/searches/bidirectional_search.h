@@ -10,18 +10,33 @@ class BidirectionalSearch : public SymSearch {
 private:
   std::unique_ptr<UniformCostSearch> fw, bw;
 
+  // If set, the images of bw are computed with this state space (with its
+  // own CUDD manager) at the same time as the images of fw
+  SymStateSpaceManager *bw_image_mgr;
+
   // Returns the best direction to search the bd exp
   UniformCostSearch *selectBestDirection() const;
 
 public:
   BidirectionalSearch(SymbolicSearch *eng, const SymParamsSearch &params,
                       std::unique_ptr<UniformCostSearch> fw,
-                      std::unique_ptr<UniformCostSearch> bw);
+                      std::unique_ptr<UniformCostSearch> bw,
+                      SymStateSpaceManager *bw_image_mgr = nullptr);
 
   virtual bool finished() const override;
 
   virtual bool stepImage(int maxTime, int maxNodes) override;
 
+  virtual void write(SymCheckpointWriter &writer) const override {
+    fw->write(writer);
+    bw->write(writer);
+  }
+
+  virtual void read(SymCheckpointReader &reader) override {
+    fw->read(reader);
+    bw->read(reader);
+  }
+
   virtual int getF() const override {
     return std::max<int>(std::max<int>(fw->getF(), bw->getF()),
                          fw->getG() + bw->getG() +
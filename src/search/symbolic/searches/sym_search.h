@@ -11,6 +11,8 @@
 
 namespace symbolic {
 class SymbolicSearch;
+class SymCheckpointWriter;
+class SymCheckpointReader;
 
 class SymSearch {
 protected:
@@ -52,6 +54,11 @@ public:
   virtual long nextStepNodesResult() const = 0;
 
   virtual bool isSearchableWithNodes(int maxNodes) const = 0;
+
+  // Checkpoints of the open and closed states. read() must be called after
+  // the search has been initialized and replaces its state
+  virtual void write(SymCheckpointWriter &writer) const = 0;
+  virtual void read(SymCheckpointReader &reader) = 0;
 };
 } // namespace symbolic
 #endif // SYMBOLIC_SEARCH
\ No newline at end of file
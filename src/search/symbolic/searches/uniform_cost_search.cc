@@ -4,6 +4,7 @@
 #include "../frontier.h"
 #include "../plan_reconstruction/sym_solution_cut.h"
 #include "../search_engines/symbolic_search.h"
+#include "../sym_checkpoint.h"
 #include "../sym_utils.h"
 #include "../utils/timer.h"
 
@@ -11,6 +12,7 @@
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <thread>
 
 using namespace std;
 using utils::g_timer;
@@ -127,8 +129,8 @@ void UniformCostSearch::filterFrontier() {
   removeZero(frontier.bucket());
 }
 
-bool UniformCostSearch::stepImage(int maxTime, int maxNodes) {
-  Timer sTime;
+bool UniformCostSearch::prepareImage(int maxTime, int maxNodes,
+                                     const Timer &sTime) {
   Result prepare_res =
       frontier.prepare(maxTime, maxNodes, fw, initialization());
   if (!prepare_res.ok) {
@@ -141,6 +143,14 @@ bool UniformCostSearch::stepImage(int maxTime, int maxNodes) {
     }
     return false;
   }
+  return true;
+}
+
+bool UniformCostSearch::stepImage(int maxTime, int maxNodes) {
+  Timer sTime;
+  if (!prepareImage(maxTime, maxNodes, sTime)) {
+    return false;
+  }
 
   if (engine->solved()) {
     return true; // Skip image if we are done
@@ -148,7 +158,47 @@ bool UniformCostSearch::stepImage(int maxTime, int maxNodes) {
 
   int stepNodes = frontier.nodes();
   ResultExpansion res_expansion = frontier.expand(maxTime, maxNodes, fw);
+  mgr->recluster_transitions_if_due();
+  return processImage(res_expansion, stepNodes, sTime);
+}
 
+bool UniformCostSearch::stepImageParallel(UniformCostSearch &first,
+                                          UniformCostSearch &second,
+                                          SymStateSpaceManager *image_mgr,
+                                          int maxTime, int maxNodes) {
+  Timer sTime;
+  if (!first.prepareImage(maxTime, maxNodes, sTime) ||
+      !second.prepareImage(maxTime, maxNodes, sTime)) {
+    return false;
+  }
+
+  if (first.engine->solved()) {
+    return true; // Skip image if we are done
+  }
+
+  int first_nodes = first.frontier.nodes();
+  int second_nodes = second.frontier.nodes();
+  bool second_zero = second.frontier.nextStepZero();
+  Bucket second_bucket = second.frontier.copy_prepared_bucket(image_mgr);
+  ResultExpansion second_res(second_zero, TruncatedReason::IMAGE_COST, 0);
+  thread second_image([&]() {
+    second_res = Frontier::compute_image(image_mgr, second_bucket, second_zero,
+                                         maxTime, maxNodes, second.fw);
+  });
+  ResultExpansion first_res = first.frontier.expand(maxTime, maxNodes, first.fw);
+  second_image.join();
+  Bucket().swap(second_bucket);
+  first.mgr->recluster_transitions_if_due();
+  image_mgr->recluster_transitions_if_due();
+  second.frontier.receive_image(second_res);
+
+  bool first_ok = first.processImage(first_res, first_nodes, sTime);
+  bool second_ok = second.processImage(second_res, second_nodes, sTime);
+  return first_ok && second_ok;
+}
+
+bool UniformCostSearch::processImage(ResultExpansion &res_expansion,
+                                     int stepNodes, const Timer &sTime) {
   if (res_expansion.ok) {
     lastStepCost = false; // Must be set to false before calling checkCut
     // Process Simg, removing duplicates and computing h. Store in Sfilter and
@@ -199,6 +249,23 @@ bool UniformCostSearch::stepImage(int maxTime, int maxNodes) {
   return res_expansion.ok;
 }
 
+void UniformCostSearch::write(SymCheckpointWriter &writer) const {
+  closed->write(writer);
+  open_list.write(writer);
+  frontier.write(writer);
+  writer.write(lastStepCost);
+  writer.write(last_g_cost);
+}
+
+// The step estimations are not restored, they adapt again after a few steps
+void UniformCostSearch::read(SymCheckpointReader &reader) {
+  closed->read(reader);
+  open_list.read(reader);
+  frontier.read(reader);
+  reader.read(lastStepCost);
+  reader.read(last_g_cost);
+}
+
 bool UniformCostSearch::isSearchableWithNodes(int maxNodes) const {
   return frontier.expansionReady() && nextStepNodes() <= maxNodes;
 }
@@ -78,6 +78,12 @@ protected:
 
   void computeEstimation(bool prepare);
 
+  // First and last part of stepImage: filters and merges the frontier
+  // before the image, and processes the result of the image.
+  bool prepareImage(int maxTime, int maxNodes, const utils::Timer &sTime);
+  bool processImage(ResultExpansion &res_expansion, int stepNodes,
+                    const utils::Timer &sTime);
+
   //////////////////////////////////////////////////////////////////////////////
 public:
   UniformCostSearch(SymbolicSearch *eng, const SymParamsSearch &params);
@@ -93,6 +99,25 @@ public:
 
   virtual bool stepImage(int maxTime, int maxNodes);
 
+  /*
+   * Performs an image step of both searches at the same time. The image of
+   * second is computed on another thread with image_mgr, which must have
+   * its own CUDD manager with the same BDD variables as second.
+   */
+  static bool stepImageParallel(UniformCostSearch &first,
+                                UniformCostSearch &second,
+                                SymStateSpaceManager *image_mgr, int maxTime,
+                                int maxNodes);
+
+  /*
+   * Turns the search into BDDA*: open states are ordered by g + h, where
+   * layers[h] contains the states with heuristic value h. The heuristic
+   * must be consistent. Must be called before init().
+   */
+  void set_heuristic(const std::vector<BDD> &layers) {
+    open_list.set_heuristic(layers);
+  }
+
   bool
   init(std::shared_ptr<SymStateSpaceManager> manager, bool fw,
        UniformCostSearch *opposite_search); // Init forward or backward search
@@ -100,7 +125,7 @@ public:
   virtual bool isSearchableWithNodes(int maxNodes) const;
 
   virtual int getF() const override {
-    return open_list.minNextG(frontier, mgr->getAbsoluteMinTransitionCost());
+    return open_list.minNextF(frontier, mgr->getAbsoluteMinTransitionCost());
   }
 
   virtual int getG() const {
@@ -120,7 +145,8 @@ public:
   BDD getExpanded() const;
   void getNotExpanded(Bucket &res) const;
 
-  // void write(const std::string & file) const;
+  virtual void write(SymCheckpointWriter &writer) const override;
+  virtual void read(SymCheckpointReader &reader) override;
 
   void filterMutex(Bucket &bucket) {
     mgr->filterMutex(bucket, fw, initialization());
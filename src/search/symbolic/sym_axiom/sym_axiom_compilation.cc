@@ -9,7 +9,7 @@
 namespace symbolic {
 using namespace std;
 
-SymAxiomCompilation::SymAxiomCompilation(std::shared_ptr<SymVariables> sym_vars)
+SymAxiomCompilation::SymAxiomCompilation(SymVariables *sym_vars)
     : sym_vars(sym_vars), task(*tasks::g_root_task) {}
 
 bool SymAxiomCompilation::is_derived_variable(int var) const {
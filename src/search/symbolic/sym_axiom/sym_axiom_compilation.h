@@ -13,7 +13,7 @@ class SymVariables;
 class SymAxiomCompilation {
 
 public:
-  SymAxiomCompilation(std::shared_ptr<SymVariables> sym_vars);
+  SymAxiomCompilation(SymVariables *sym_vars);
 
   bool is_derived_variable(int var) const;
   bool is_in_body(int var, int axiom_id) const;
@@ -28,7 +28,7 @@ public:
   BDD get_primary_representation(int var, int val) const;
 
 protected:
-  std::shared_ptr<SymVariables> sym_vars; // For axiom creation
+  SymVariables *sym_vars; // For axiom creation (not owned)
   TaskProxy task;
   std::vector<int> axiom_body_layer;
   std::map<int, BDD> primary_representations;
@@ -1,6 +1,8 @@
 #ifndef SYMBOLIC_SYM_BUCKET_H
 #define SYMBOLIC_SYM_BUCKET_H
 
+// Must precede cuddObj.hh to declare the variable group functions
+#include "mtr.h"
 #include "cuddObj.hh"
 #include <vector>
 
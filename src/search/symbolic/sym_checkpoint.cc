@@ -0,0 +1,243 @@
+#include "sym_checkpoint.h"
+
+#include "sym_variables.h"
+
+#include "../operator_id.h"
+#include "../state_registry.h"
+#include "../task_proxy.h"
+#include "../utils/hash.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+
+#include "dddmp.h"
+
+using namespace std;
+
+namespace symbolic {
+static const char CHECKPOINT_FILE_MAGIC[4] = {'S', 'Y', 'M', 'K'};
+static const int CHECKPOINT_FILE_VERSION = 1;
+
+static uint64_t compute_fingerprint(SymVariables &vars) {
+  const TaskProxy &task_proxy = vars.get_state_registry()->get_task_proxy();
+  utils::HashState hash_state;
+  utils::feed(hash_state, vars.get_var_order());
+  for (VariableProxy var : task_proxy.get_variables()) {
+    utils::feed(hash_state, var.get_domain_size());
+  }
+  for (OperatorProxy op : task_proxy.get_operators()) {
+    utils::feed(hash_state, static_cast<int>(op.get_preconditions().size()));
+    for (FactProxy pre : op.get_preconditions()) {
+      utils::feed(hash_state, pre.get_pair());
+    }
+    utils::feed(hash_state, static_cast<int>(op.get_effects().size()));
+    for (EffectProxy eff : op.get_effects()) {
+      utils::feed(hash_state, eff.get_fact().get_pair());
+    }
+    utils::feed(hash_state, op.get_cost());
+  }
+  for (FactProxy goal : task_proxy.get_goals()) {
+    utils::feed(hash_state, goal.get_pair());
+  }
+  for (FactProxy fact : task_proxy.get_initial_state()) {
+    utils::feed(hash_state, fact.get_value());
+  }
+  return hash_state.get_hash64();
+}
+
+void SymCheckpointWriter::write(const BDD &bdd) {
+  write(static_cast<int>(bdds.size()));
+  bdds.push_back(bdd);
+}
+
+void SymCheckpointWriter::write(const Bucket &bucket) {
+  write(static_cast<int>(bucket.size()));
+  for (const BDD &bdd : bucket) {
+    write(bdd);
+  }
+}
+
+void SymCheckpointWriter::write(const Plan &plan) {
+  write(static_cast<int>(plan.size()));
+  for (OperatorID op : plan) {
+    write(op.get_index());
+  }
+}
+
+void SymCheckpointWriter::write(const std::string &str) {
+  write(static_cast<int>(str.size()));
+  data.write(str.data(), str.size());
+}
+
+void SymCheckpointWriter::save(const std::string &file_name,
+                               SymVariables &vars) const {
+  FILE *file = fopen(file_name.c_str(), "wb");
+  if (!file) {
+    cerr << "Could not write checkpoint to " << file_name << endl;
+    utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+  }
+  uint64_t fingerprint = compute_fingerprint(vars);
+  string bytes = data.str();
+  uint64_t num_bytes = bytes.size();
+  int num_bdds = bdds.size();
+  fwrite(CHECKPOINT_FILE_MAGIC, 1, sizeof(CHECKPOINT_FILE_MAGIC), file);
+  fwrite(&CHECKPOINT_FILE_VERSION, sizeof(CHECKPOINT_FILE_VERSION), 1, file);
+  fwrite(&fingerprint, sizeof(fingerprint), 1, file);
+  fwrite(&num_bytes, sizeof(num_bytes), 1, file);
+  fwrite(bytes.data(), 1, bytes.size(), file);
+  fwrite(&num_bdds, sizeof(num_bdds), 1, file);
+
+  bool ok = !ferror(file);
+  if (ok && num_bdds > 0) {
+    vector<DdNode *> roots;
+    roots.reserve(num_bdds);
+    for (const BDD &bdd : bdds) {
+      roots.push_back(bdd.getNode());
+    }
+    ok = Dddmp_cuddBddArrayStore(vars.get_manager()->getManager(), nullptr,
+                                 num_bdds, roots.data(), nullptr, nullptr,
+                                 nullptr, DDDMP_MODE_BINARY, DDDMP_VARIDS,
+                                 nullptr, file) == DDDMP_SUCCESS;
+  }
+  if (fclose(file) != 0 || !ok) {
+    cerr << "Could not write checkpoint to " << file_name << endl;
+    utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+  }
+  cout << "Saved checkpoint with " << num_bdds << " BDDs to " << file_name
+       << endl;
+}
+
+SymCheckpointReader::SymCheckpointReader(const std::string &file_name,
+                                         SymVariables &vars)
+    : file_name(file_name), num_data_bytes(0),
+      num_operators(
+          vars.get_state_registry()->get_task_proxy().get_operators().size()) {
+  unique_ptr<FILE, int (*)(FILE *)> file(fopen(file_name.c_str(), "rb"),
+                                         fclose);
+  if (!file) {
+    exit_with_error("cannot open file");
+  }
+  char magic[4];
+  int version = 0;
+  if (fread(magic, 1, sizeof(magic), file.get()) != sizeof(magic) ||
+      fread(&version, sizeof(version), 1, file.get()) != 1 ||
+      !equal(magic, magic + 4, CHECKPOINT_FILE_MAGIC) ||
+      version != CHECKPOINT_FILE_VERSION) {
+    exit_with_error("not a checkpoint file of this version");
+  }
+  uint64_t fingerprint = 0;
+  uint64_t num_bytes = 0;
+  if (fread(&fingerprint, sizeof(fingerprint), 1, file.get()) != 1 ||
+      fread(&num_bytes, sizeof(num_bytes), 1, file.get()) != 1) {
+    exit_with_error("corrupt header");
+  }
+  if (fingerprint != compute_fingerprint(vars)) {
+    exit_with_error("the checkpoint was written for another task or "
+                    "variable order");
+  }
+  // Do not trust the size before checking that the file holds the data
+  long start = ftell(file.get());
+  if (start < 0 || fseek(file.get(), 0, SEEK_END) != 0) {
+    exit_with_error("cannot determine the file size");
+  }
+  uint64_t available = ftell(file.get()) - start;
+  if (num_bytes > available || fseek(file.get(), start, SEEK_SET) != 0) {
+    exit_with_error("file ends prematurely");
+  }
+  string bytes(num_bytes, '\0');
+  int num_bdds = 0;
+  if (fread(&bytes[0], 1, num_bytes, file.get()) != num_bytes ||
+      fread(&num_bdds, sizeof(num_bdds), 1, file.get()) != 1 ||
+      num_bdds < 0) {
+    exit_with_error("file ends prematurely");
+  }
+  data.str(bytes);
+  num_data_bytes = num_bytes;
+
+  if (num_bdds > 0) {
+    Cudd *manager = vars.get_manager();
+    DdNode **roots = nullptr;
+    int num_loaded = Dddmp_cuddBddArrayLoad(
+        manager->getManager(), DDDMP_ROOT_MATCHLIST, nullptr,
+        DDDMP_VAR_MATCHIDS, nullptr, nullptr, nullptr, DDDMP_MODE_BINARY,
+        nullptr, file.get(), &roots);
+    if (num_loaded != num_bdds || !roots) {
+      exit_with_error("cannot load the BDDs");
+    }
+    bdds.reserve(num_bdds);
+    for (int i = 0; i < num_bdds; ++i) {
+      // The loaded roots are referenced, the BDDs take over the reference
+      bdds.emplace_back(*manager, roots[i]);
+      Cudd_RecursiveDeref(manager->getManager(), roots[i]);
+    }
+    free(roots);
+  }
+}
+
+void SymCheckpointReader::check_data() const {
+  if (!data) {
+    exit_with_error("file ends prematurely");
+  }
+}
+
+void SymCheckpointReader::check_size(int size, size_t element_size) {
+  size_t remaining = num_data_bytes - static_cast<size_t>(data.tellg());
+  if (size < 0 || remaining / element_size < static_cast<size_t>(size)) {
+    exit_with_error("corrupt size of a list");
+  }
+}
+
+void SymCheckpointReader::read(BDD &bdd) {
+  int pos = -1;
+  read(pos);
+  if (pos < 0 || static_cast<size_t>(pos) >= bdds.size()) {
+    exit_with_error("reference to a missing BDD");
+  }
+  bdd = bdds[pos];
+}
+
+void SymCheckpointReader::read(Bucket &bucket) {
+  int size = 0;
+  read(size);
+  check_size(size, sizeof(int));
+  bucket.resize(size);
+  for (BDD &bdd : bucket) {
+    read(bdd);
+  }
+}
+
+void SymCheckpointReader::read(Plan &plan) {
+  int size = 0;
+  read(size);
+  check_size(size, sizeof(int));
+  plan.clear();
+  plan.reserve(size);
+  for (int i = 0; i < size; ++i) {
+    int op = -1;
+    read(op);
+    if (op < 0 || op >= num_operators) {
+      exit_with_error("plan with an operator that is not in the task");
+    }
+    plan.emplace_back(op);
+  }
+}
+
+void SymCheckpointReader::read(std::string &str) {
+  int size = 0;
+  read(size);
+  check_size(size, 1);
+  str.resize(size);
+  data.read(&str[0], size);
+  check_data();
+}
+
+void SymCheckpointReader::exit_with_error(const std::string &message) const {
+  cerr << "Could not load checkpoint from " << file_name << ": " << message
+       << endl;
+  utils::exit_with(utils::ExitCode::SEARCH_INPUT_ERROR);
+}
+} // namespace symbolic
@@ -0,0 +1,79 @@
+#ifndef SYMBOLIC_SYM_CHECKPOINT_H
+#define SYMBOLIC_SYM_CHECKPOINT_H
+
+#include "../plan_manager.h"
+#include "../utils/language.h"
+#include "sym_bucket.h"
+
+#include <sstream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace symbolic {
+class SymVariables;
+
+/*
+ * State of a search written to disk, so that a later run of the planner can
+ * continue the search. Plain data is written in binary and each BDD as its
+ * position in a list. The list is stored at the end of the file with dddmp,
+ * so that nodes shared by several BDDs are stored once.
+ *
+ * The file starts with a fingerprint of the task, including its initial
+ * state, and of the variable order: the BDDs are only meaningful for the
+ * same BDD variables.
+ */
+class SymCheckpointWriter {
+  std::ostringstream data;
+  std::vector<BDD> bdds;
+
+public:
+  template <class T> void write(const T &value) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "only plain data can be written directly");
+    data.write(reinterpret_cast<const char *>(&value), sizeof(T));
+  }
+
+  void write(const BDD &bdd);
+  void write(const Bucket &bucket);
+  void write(const Plan &plan);
+  void write(const std::string &str);
+
+  // Exits if the file cannot be written
+  void save(const std::string &file_name, SymVariables &vars) const;
+};
+
+class SymCheckpointReader {
+  std::string file_name;
+  std::istringstream data;
+  std::vector<BDD> bdds;
+  size_t num_data_bytes;
+  int num_operators;
+
+  void check_data() const;
+
+  // Exits unless the data still holds size elements of element_size bytes
+  void check_size(int size, size_t element_size);
+
+public:
+  // Exits if the file is not a checkpoint for the task and BDD variables
+  SymCheckpointReader(const std::string &file_name, SymVariables &vars);
+
+  template <class T> void read(T &value) {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "only plain data can be read directly");
+    data.read(reinterpret_cast<char *>(&value), sizeof(T));
+    check_data();
+  }
+
+  void read(BDD &bdd);
+  void read(Bucket &bucket);
+  void read(Plan &plan);
+  void read(std::string &str);
+
+  // Exits after reporting that the file cannot be loaded
+  NO_RETURN void exit_with_error(const std::string &message) const;
+};
+} // namespace symbolic
+
+#endif
@@ -39,9 +39,17 @@ std::ostream &operator<<(std::ostream &os, const MutexType &m) {
   }
 }
 
+std::ostream &operator<<(std::ostream &os, const ReorderingMethod &m) {
+  return os << ReorderingMethodValues[static_cast<int>(m)];
+}
+
 const std::vector<std::string> MutexTypeValues{
     "MUTEX_NOT", "MUTEX_AND", "MUTEX_EDELETION",
     /*"MUTEX_RESTRICT", "MUTEX_NPAND", "MUTEX_CONSTRAIN", "MUTEX_LICOMP"*/};
 
 const std::vector<std::string> DirValues{"FW", "BW", "BIDIR"};
+
+const std::vector<std::string> ReorderingMethodValues{
+    "NONE",       "SIFT",    "SIFT_CONVERGE", "SYMM_SIFT", "GROUP_SIFT",
+    "GROUP_SIFT_CONVERGE", "WINDOW2", "WINDOW3", "LAZY_SIFT"};
 } // namespace symbolic
@@ -25,6 +25,21 @@ enum class Dir { FW, BW, BIDIR };
 std::ostream &operator<<(std::ostream &os, const Dir &dir);
 extern const std::vector<std::string> DirValues;
 
+// Dynamic variable reordering methods of CUDD
+enum class ReorderingMethod {
+  NONE,
+  SIFT,
+  SIFT_CONVERGE,
+  SYMM_SIFT,
+  GROUP_SIFT,
+  GROUP_SIFT_CONVERGE,
+  WINDOW2,
+  WINDOW3,
+  LAZY_SIFT
+};
+std::ostream &operator<<(std::ostream &os, const ReorderingMethod &m);
+extern const std::vector<std::string> ReorderingMethodValues;
+
 // We use this enumerate to know why the current operation was truncated
 enum class TruncatedReason {
   FILTER_MUTEX,
@@ -7,6 +7,7 @@
 #include "../task_proxy.h"
 #include "../task_utils/task_properties.h"
 #include "../utils/timer.h"
+#include "parallel_image.h"
 #include "sym_enums.h"
 #include "sym_utils.h"
 
@@ -23,7 +24,7 @@ SymStateSpaceManager::SymStateSpaceManager(SymVariables *v,
                                            const set<int> &relevant_vars_)
     : vars(v), p(params), relevant_vars(relevant_vars_),
       initialState(v->zeroBDD()), goal(v->zeroBDD()), min_transition_cost(0),
-      hasTR0(false) {
+      hasTR0(false), num_timed_images(0) {
 
   if (relevant_vars.empty()) {
     for (int i = 0; i < tasks::g_root_task->get_num_variables(); ++i) {
@@ -48,46 +49,72 @@ void SymStateSpaceManager::dumpMutexBDDs(bool fw) const {
   }
 }
 
-void SymStateSpaceManager::zero_preimage(const BDD &bdd, vector<BDD> &res,
-                                         int nodeLimit) const {
-  for (const auto &tr : transitions.at(0)) {
-    res.push_back(tr.preimage(bdd, nodeLimit));
+void SymStateSpaceManager::image(bool fw, int cost, const BDD &bdd,
+                                 vector<BDD> &res, int nodeLimit) {
+  const vector<TransitionRelation> &trs = transitions.at(cost);
+  bool timed = !image_times.empty();
+  for (size_t i = 0; i < trs.size(); ++i) {
+    utils::Timer image_timer;
+    res.push_back(fw ? trs[i].image(bdd, nodeLimit)
+                     : trs[i].preimage(bdd, nodeLimit));
+    if (timed) {
+      image_times[cost][i] += image_timer();
+    }
   }
 }
 
-void SymStateSpaceManager::zero_image(const BDD &bdd, vector<BDD> &res,
-                                      int nodeLimit) const {
-  for (const auto &tr : transitions.at(0)) {
-    res.push_back(tr.image(bdd, nodeLimit));
+void SymStateSpaceManager::zero_image(bool fw, const BDD &bdd,
+                                      vector<BDD> &res, int maxNodes) {
+  if (parallel_image) {
+    map<int, Bucket> images;
+    parallel_image->image(fw, true, bdd, images, maxNodes);
+    res.insert(res.end(), images[0].begin(), images[0].end());
+  } else {
+    image(fw, 0, bdd, res, maxNodes);
   }
 }
 
-void SymStateSpaceManager::cost_preimage(const BDD &bdd,
-                                         map<int, vector<BDD>> &res,
-                                         int nodeLimit) const {
-
-  for (auto trs : transitions) {
+void SymStateSpaceManager::cost_image(bool fw, const BDD &bdd,
+                                      map<int, vector<BDD>> &res,
+                                      int maxNodes) {
+  if (parallel_image) {
+    parallel_image->image(fw, false, bdd, res, maxNodes);
+    return;
+  }
+  for (const auto &trs : transitions) {
     int cost = trs.first;
-    if (cost == 0)
-      continue;
-    for (size_t i = 0; i < trs.second.size(); i++) {
-      BDD result = trs.second[i].preimage(bdd, nodeLimit);
-      res[cost].push_back(result);
+    if (cost != 0) {
+      image(fw, cost, bdd, res[cost], maxNodes);
     }
   }
+  if (!image_times.empty()) {
+    ++num_timed_images;
+  }
 }
 
-void SymStateSpaceManager::cost_image(const BDD &bdd,
-                                      map<int, vector<BDD>> &res,
-                                      int nodeLimit) const {
-  for (auto trs : transitions) {
-    int cost = trs.first;
-    if (cost == 0)
-      continue;
-    for (size_t i = 0; i < trs.second.size(); i++) {
-      BDD result = trs.second[i].image(bdd, nodeLimit);
-      res[cost].push_back(result);
-    }
+void SymStateSpaceManager::recluster_transitions_if_due() {
+  if (!image_times.empty() && num_timed_images >= p.adaptive_tr_images) {
+    recluster_transitions();
+  }
+}
+
+void SymStateSpaceManager::init_parallel_image(
+    const vector<shared_ptr<SymVariables>> &worker_vars) {
+  assert(!transitions.empty());
+  parallel_image = make_shared<ParallelImage>(vars, transitions, worker_vars);
+}
+
+void SymStateSpaceManager::setTimeLimit(int maxTime) {
+  vars->setTimeLimit(maxTime);
+  if (parallel_image) {
+    parallel_image->setTimeLimit(maxTime);
+  }
+}
+
+void SymStateSpaceManager::unsetTimeLimit() {
+  vars->unsetTimeLimit();
+  if (parallel_image) {
+    parallel_image->unsetTimeLimit();
   }
 }
 
@@ -161,9 +188,20 @@ void SymStateSpaceManager::init_transitions(
     return;
   }
 
-  for (map<int, vector<TransitionRelation>>::iterator it = transitions.begin();
-       it != transitions.end(); ++it) {
-    merge(vars, it->second, mergeTR, p.max_tr_time, p.max_tr_size);
+  // Partitioned TRs are kept separate, so there is nothing to cluster
+  if (!p.partitioned_trs) {
+    for (map<int, vector<TransitionRelation>>::iterator it =
+             transitions.begin();
+         it != transitions.end(); ++it) {
+      merge(vars, it->second, mergeTR, p.max_tr_time, p.max_tr_size);
+    }
+  }
+
+  if (p.adaptive_tr_images > 0 && !p.partitioned_trs) {
+    individual_trs = indTRs;
+    for (const auto &trs : transitions) {
+      image_times[trs.first].assign(trs.second.size(), 0);
+    }
   }
 
   min_transition_cost = transitions.begin()->first;
@@ -178,6 +216,8 @@ void SymStateSpaceManager::init_transitions(
 SymParamsMgr::SymParamsMgr(const options::Options &opts)
     : max_tr_size(opts.get<int>("max_tr_size")),
       max_tr_time(opts.get<int>("max_tr_time")),
+      adaptive_tr_images(opts.get<int>("adaptive_tr_images")),
+      partitioned_trs(opts.get<bool>("partitioned_trs")),
       mutex_type(MutexType(opts.get_enum("mutex_type"))),
       max_mutex_size(opts.get<int>("max_mutex_size")),
       max_mutex_time(opts.get<int>("max_mutex_time")),
@@ -195,9 +235,10 @@ SymParamsMgr::SymParamsMgr(const options::Options &opts)
 }
 
 SymParamsMgr::SymParamsMgr()
-    : max_tr_size(100000), max_tr_time(60000),
-      mutex_type(MutexType::MUTEX_EDELETION), max_mutex_size(100000),
-      max_mutex_time(60000), max_aux_nodes(1000000), max_aux_time(2000) {
+    : max_tr_size(100000), max_tr_time(60000), adaptive_tr_images(0),
+      partitioned_trs(false), mutex_type(MutexType::MUTEX_EDELETION),
+      max_mutex_size(100000), max_mutex_time(60000), max_aux_nodes(1000000),
+      max_aux_time(2000) {
   // Don't use edeletion with conditional effects
   TaskProxy task_proxy(*tasks::g_root_task);
   if (mutex_type == MutexType::MUTEX_EDELETION &&
@@ -209,8 +250,68 @@ SymParamsMgr::SymParamsMgr()
   }
 }
 
+void SymStateSpaceManager::recluster_transitions() {
+  double total_time = 0;
+  int num_trs = 0;
+  for (const auto &times : image_times) {
+    for (double time : times.second) {
+      total_time += time;
+      num_trs++;
+    }
+  }
+  double avg_time = total_time / num_trs;
+
+  for (auto &trs : transitions) {
+    int cost = trs.first;
+    const vector<double> &times = image_times[cost];
+    vector<TransitionRelation> new_trs, cheap_trs;
+    for (size_t i = 0; i < trs.second.size(); ++i) {
+      const TransitionRelation &tr = trs.second[i];
+      if (times[i] > 2 * avg_time && tr.getOpsIds().size() > 1) {
+        // Split in two halves of its operators
+        vector<TransitionRelation> halves[2];
+        for (const TransitionRelation &ind_tr : individual_trs[cost]) {
+          const OperatorID &op_id = *ind_tr.getOpsIds().begin();
+          if (tr.getOpsIds().count(op_id)) {
+            int half = halves[0].size() > halves[1].size();
+            halves[half].push_back(ind_tr);
+          }
+        }
+        for (vector<TransitionRelation> &half : halves) {
+          merge(vars, half, mergeTR, p.max_tr_time, p.max_tr_size / 2);
+          new_trs.insert(new_trs.end(), half.begin(), half.end());
+        }
+      } else if (times[i] < avg_time / 2) {
+        cheap_trs.push_back(tr);
+      } else {
+        new_trs.push_back(tr);
+      }
+    }
+    // Cheap TRs may grow beyond max_tr_size
+    merge(vars, cheap_trs, mergeTR, p.max_tr_time, 2 * p.max_tr_size);
+    new_trs.insert(new_trs.end(), cheap_trs.begin(), cheap_trs.end());
+    trs.second.swap(new_trs);
+  }
+
+  individual_trs.clear();
+  image_times.clear();
+  print_transitions();
+}
+
+void SymStateSpaceManager::print_transitions() const {
+  for (const auto &trs : transitions) {
+    cout << "TR clusters of cost " << trs.first << ":";
+    for (const TransitionRelation &tr : trs.second) {
+      cout << " " << tr.getOpsIds().size() << "/" << tr.nodeCount();
+    }
+    cout << " (operators/nodes)" << endl;
+  }
+}
+
 void SymParamsMgr::print_options() const {
-  cout << "TR(time=" << max_tr_time << ", nodes=" << max_tr_size << ")" << endl;
+  cout << "TR(time=" << max_tr_time << ", nodes=" << max_tr_size
+       << ", adaptive_images=" << adaptive_tr_images
+       << ", partitioned=" << partitioned_trs << ")" << endl;
   cout << "Mutex(time=" << max_mutex_time << ", nodes=" << max_mutex_size
        << ", type=" << mutex_type << ")" << endl;
   cout << "Aux(time=" << max_aux_time << ", nodes=" << max_aux_nodes << ")"
@@ -223,6 +324,21 @@ void SymParamsMgr::add_options_to_parser(options::OptionParser &parser) {
   parser.add_option<int>("max_tr_time", "maximum time (ms) to generate TR BDDs",
                          "60000");
 
+  parser.add_option<int>(
+      "adaptive_tr_images",
+      "measure the time of each TR in this many images and then split the "
+      "slow TRs and merge the fast ones (0: keep the TRs merged up to "
+      "max_tr_size)",
+      "0", options::Bounds("0", "infinity"));
+
+  parser.add_option<bool>(
+      "partitioned_trs",
+      "represent the TR of each operator as a conjunction of its "
+      "preconditions and its effects on each variable, quantifying each "
+      "variable right after its last conjunct; these TRs are never merged "
+      "and adaptive_tr_images is ignored",
+      "false");
+
   parser.add_enum_option("mutex_type", MutexTypeValues, "mutex type",
                          "MUTEX_EDELETION");
 
@@ -20,6 +20,7 @@ class Options;
 } // namespace options
 
 namespace symbolic {
+class ParallelImage;
 class SymVariables;
 class TransitionRelation;
 
@@ -31,6 +32,10 @@ class SymParamsMgr {
 public:
   // Parameters to generate the TRs
   int max_tr_size, max_tr_time;
+  // Number of images after which the TRs are re-clustered (0: never)
+  int adaptive_tr_images;
+  // Conjunctively partitioned TRs, which are not merged
+  bool partitioned_trs;
 
   // Parameters to generate the mutex BDDs
   MutexType mutex_type;
@@ -46,12 +51,14 @@ public:
 };
 
 class SymStateSpaceManager {
-  void zero_preimage(const BDD &bdd, std::vector<BDD> &res, int maxNodes) const;
-  void cost_preimage(const BDD &bdd, std::map<int, std::vector<BDD>> &res,
-                     int maxNodes) const;
-  void zero_image(const BDD &bdd, std::vector<BDD> &res, int maxNodes) const;
-  void cost_image(const BDD &bdd, std::map<int, std::vector<BDD>> &res,
-                  int maxNodes) const;
+  // Images wrt the TRs of the given cost
+  void image(bool fw, int cost, const BDD &bdd, std::vector<BDD> &res,
+             int maxNodes);
+
+  // Splits the TR clusters whose images are slow and merges the fast ones,
+  // according to the times measured in the first adaptive_tr_images images
+  void recluster_transitions();
+  void print_transitions() const;
 
 protected:
   SymVariables *vars;
@@ -67,6 +74,15 @@ protected:
   int min_transition_cost; // minimum cost of non-zero cost transitions
   bool hasTR0;             // If there is transitions with cost 0
 
+  // If set, images are computed by several threads (see init_parallel_image)
+  std::shared_ptr<ParallelImage> parallel_image;
+
+  // For adaptive clustering: individual TRs and accumulated image time (s)
+  // of each TR in transitions
+  std::map<int, std::vector<TransitionRelation>> individual_trs;
+  std::map<int, std::vector<double>> image_times;
+  int num_timed_images;
+
   // BDD representation of valid states (wrt mutex) for fw and bw search
   std::vector<BDD> notMutexBDDsFw, notMutexBDDsBw;
 
@@ -89,6 +105,11 @@ public:
 
   virtual ~SymStateSpaceManager() {}
 
+  // Distributes the TRs over one worker per manager of worker_vars, which
+  // must have the same BDD variables as vars. Requires initialized TRs.
+  void init_parallel_image(
+      const std::vector<std::shared_ptr<SymVariables>> &worker_vars);
+
   void filterMutex(Bucket &bucket, bool fw, bool initialization);
   void mergeBucket(Bucket &bucket) const;
   void mergeBucketAnd(Bucket &bucket) const;
@@ -157,31 +178,23 @@ public:
   }
 
   void zero_image(bool fw, const BDD &bdd, std::vector<BDD> &res,
-                  int maxNodes) {
-    if (fw) {
-      zero_image(bdd, res, maxNodes);
-    } else {
-      zero_preimage(bdd, res, maxNodes);
-    }
-  }
+                  int maxNodes);
 
   void cost_image(bool fw, const BDD &bdd, std::map<int, std::vector<BDD>> &res,
-                  int maxNodes) {
-    if (fw) {
-      cost_image(bdd, res, maxNodes);
-    } else {
-      cost_preimage(bdd, res, maxNodes);
-    }
-  }
+                  int maxNodes);
+
+  // Reclusters the TRs once adaptive_tr_images images have been timed. Must
+  // be called between images: merging sets and unsets its own time limit.
+  void recluster_transitions_if_due();
 
   BDD filter_mutex(const BDD &bdd, bool fw, int maxNodes, bool initialization);
 
   int filterMutexBucket(std::vector<BDD> &bucket, bool fw, bool initialization,
                         int maxTime, int maxNodes);
 
-  void setTimeLimit(int maxTime) { vars->setTimeLimit(maxTime); }
+  void setTimeLimit(int maxTime);
 
-  void unsetTimeLimit() { vars->unsetTimeLimit(); }
+  void unsetTimeLimit();
 
   friend std::ostream &operator<<(std::ostream &os,
                                   const SymStateSpaceManager &state_space);
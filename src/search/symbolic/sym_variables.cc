@@ -3,11 +3,14 @@
 #include "../global_state.h"
 #include "../options/option_parser.h"
 #include "../options/options.h"
+#include "../per_task_information.h"
 #include "../task_utils/task_properties.h"
+#include "../utils/system.h"
 #include "../tasks/root_task.h"
 #include "opt_order.h"
 #include "sym_axiom/sym_axiom_compilation.h"
 
+#include <cassert>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -23,16 +26,128 @@ void exceptionError(string /*message*/) {
   throw BDDError();
 }
 
+// Approximate size (bytes) of a node and of a cache entry in 64-bit CUDD
+static const long CUDD_NODE_SIZE = 32;
+static const long CUDD_CACHE_ENTRY_SIZE = 32;
+static const long DEFAULT_CUDD_INIT_NODES = 16000000L;
+static const long DEFAULT_CUDD_INIT_CACHE_SIZE = 16000000L;
+
+static Cudd_ReorderingType get_cudd_reordering_type(ReorderingMethod method) {
+  switch (method) {
+  case ReorderingMethod::NONE:
+    return CUDD_REORDER_NONE;
+  case ReorderingMethod::SIFT:
+    return CUDD_REORDER_SIFT;
+  case ReorderingMethod::SIFT_CONVERGE:
+    return CUDD_REORDER_SIFT_CONVERGE;
+  case ReorderingMethod::SYMM_SIFT:
+    return CUDD_REORDER_SYMM_SIFT;
+  case ReorderingMethod::GROUP_SIFT:
+    return CUDD_REORDER_GROUP_SIFT;
+  case ReorderingMethod::GROUP_SIFT_CONVERGE:
+    return CUDD_REORDER_GROUP_SIFT_CONV;
+  case ReorderingMethod::WINDOW2:
+    return CUDD_REORDER_WINDOW2;
+  case ReorderingMethod::WINDOW3:
+    return CUDD_REORDER_WINDOW3;
+  case ReorderingMethod::LAZY_SIFT:
+    return CUDD_REORDER_LAZY_SIFT;
+  }
+  utils::exit_with(utils::ExitCode::SEARCH_CRITICAL_ERROR);
+}
+
 SymVariables::SymVariables(const Options &opts)
-    : cudd_init_nodes(16000000L), cudd_init_cache_size(16000000L),
-      cudd_init_available_memory(0L),
-      gamer_ordering(true) {}
+    : cudd_init_nodes(opts.contains("cudd_init_nodes")
+                          ? opts.get<int>("cudd_init_nodes")
+                          : DEFAULT_CUDD_INIT_NODES),
+      cudd_init_cache_size(opts.contains("cudd_init_cache_size")
+                               ? opts.get<int>("cudd_init_cache_size")
+                               : DEFAULT_CUDD_INIT_CACHE_SIZE),
+      cudd_init_available_memory(
+          static_cast<long>(opts.get<int>("cudd_max_memory")) * 1024 * 1024),
+      cudd_max_cache_hard(opts.get<int>("cudd_max_cache_hard")),
+      cudd_loose_up_to(opts.get<int>("cudd_loose_up_to")),
+      cudd_reordering(ReorderingMethod(opts.get_enum("cudd_reordering"))),
+      cudd_reordering_threshold(opts.get<int>("cudd_reordering_threshold")),
+      gamer_ordering(opts.get<bool>("gamer_ordering")),
+      auto_init_nodes(!opts.contains("cudd_init_nodes")),
+      auto_init_cache_size(!opts.contains("cudd_init_cache_size")),
+      init_sizes_reduced(false) {
+  fit_to_available_memory();
+}
 
 SymVariables::SymVariables(bool gamer_ordering)
-    : cudd_init_nodes(16000000L), cudd_init_cache_size(16000000L),
-      cudd_init_available_memory(0L), gamer_ordering(gamer_ordering) {}
+    : cudd_init_nodes(DEFAULT_CUDD_INIT_NODES),
+      cudd_init_cache_size(DEFAULT_CUDD_INIT_CACHE_SIZE),
+      cudd_init_available_memory(0L), cudd_max_cache_hard(0L),
+      cudd_loose_up_to(0L), cudd_reordering(ReorderingMethod::NONE),
+      cudd_reordering_threshold(0), gamer_ordering(gamer_ordering),
+      auto_init_nodes(true), auto_init_cache_size(true),
+      init_sizes_reduced(false) {
+  fit_to_available_memory();
+}
 
-void SymVariables::init() {
+void SymVariables::fit_to_available_memory() {
+  if (!auto_init_nodes && !auto_init_cache_size) {
+    return;
+  }
+  if (cudd_init_available_memory == 0) {
+    int memory_limit = utils::get_memory_limit_in_mb();
+    if (memory_limit < 0) {
+      // Let CUDD choose its limits based on the data segment size.
+      return;
+    }
+    // Leave a quarter of the memory to the rest of the planner.
+    cudd_init_available_memory = static_cast<long>(memory_limit) * 768 * 1024;
+  }
+
+  // The initial unique table and cache may take up to half of the memory.
+  // Only the sizes that were not set explicitly are reduced.
+  long fixed_memory =
+      (auto_init_nodes ? 0 : cudd_init_nodes * CUDD_NODE_SIZE) +
+      (auto_init_cache_size ? 0 : cudd_init_cache_size * CUDD_CACHE_ENTRY_SIZE);
+  long auto_memory =
+      (auto_init_nodes ? cudd_init_nodes * CUDD_NODE_SIZE : 0) +
+      (auto_init_cache_size ? cudd_init_cache_size * CUDD_CACHE_ENTRY_SIZE
+                            : 0);
+  long budget = cudd_init_available_memory / 2 - fixed_memory;
+  if (auto_memory > budget) {
+    double factor = max(budget, 0L) / static_cast<double>(auto_memory);
+    if (auto_init_nodes) {
+      cudd_init_nodes = max<long>(cudd_init_nodes * factor, 1);
+    }
+    if (auto_init_cache_size) {
+      cudd_init_cache_size = max<long>(cudd_init_cache_size * factor, 1);
+    }
+    init_sizes_reduced = true;
+  }
+}
+
+static PerTaskInformation<weak_ptr<SymVariables>> shared_sym_variables(
+    [](const TaskProxy &) {
+      return utils::make_unique_ptr<weak_ptr<SymVariables>>();
+    });
+
+shared_ptr<SymVariables> get_shared_sym_variables(const Options &opts) {
+  weak_ptr<SymVariables> &entry =
+      shared_sym_variables[TaskProxy(*tasks::g_root_task)];
+  shared_ptr<SymVariables> vars = entry.lock();
+  if (!vars) {
+    vars = make_shared<SymVariables>(opts);
+    vars->init();
+    entry = vars;
+  }
+  return vars;
+}
+
+void SymVariables::split_memory(int num_managers) {
+  assert(!manager && num_managers >= 1);
+  cudd_init_nodes /= num_managers;
+  cudd_init_cache_size /= num_managers;
+  cudd_init_available_memory /= num_managers;
+}
+
+vector<int> SymVariables::compute_var_order() const {
   vector<int> var_order;
   if (gamer_ordering) {
     InfluenceGraph::compute_gamer_ordering(var_order);
@@ -41,6 +156,20 @@ void SymVariables::init() {
       var_order.push_back(i);
     }
   }
+  return var_order;
+}
+
+vector<int> SymVariables::compute_var_order(const vector<int> &vars) const {
+  vector<int> var_order(vars);
+  // An empty order would be completed to all variables.
+  if (gamer_ordering && !var_order.empty()) {
+    InfluenceGraph::compute_gamer_ordering(var_order);
+  }
+  return var_order;
+}
+
+void SymVariables::init() {
+  vector<int> var_order = compute_var_order();
   cout << "Sym variable order: ";
   for (int v : var_order)
     cout << v << " ";
@@ -52,16 +181,16 @@ void SymVariables::init() {
 // Constructor that makes use of global variables to initialize the
 // symbolic_search structures
 
-void SymVariables::init(const vector<int> &v_order) {
-  cout << "Initializing Symbolic Variables" << endl;
+void SymVariables::init(const vector<int> &v_order, ostream &log) {
+  log << "Initializing Symbolic Variables" << endl;
   var_order = vector<int>(v_order);
-  int num_fd_vars = var_order.size();
+  int num_fd_vars = tasks::g_root_task->get_num_variables();
 
   // Initialize binary representation of variables.
   numBDDVars = 0;
-  bdd_index_pre = vector<vector<int>>(v_order.size());
-  bdd_index_eff = vector<vector<int>>(v_order.size());
-  bdd_index_abs = vector<vector<int>>(v_order.size());
+  bdd_index_pre = vector<vector<int>>(num_fd_vars);
+  bdd_index_eff = vector<vector<int>>(num_fd_vars);
+  bdd_index_abs = vector<vector<int>>(num_fd_vars);
   int _numBDDVars = 0; // numBDDVars;
   for (int var : var_order) {
     int var_len = ceil(log2(tasks::g_root_task->get_variable_domain_size(var)));
@@ -70,14 +199,27 @@ void SymVariables::init(const vector<int> &v_order) {
       bdd_index_pre[var].push_back(_numBDDVars);
       bdd_index_eff[var].push_back(_numBDDVars + 1);
       _numBDDVars += 2;
+      index_var.insert(index_var.end(), 2, var);
+      index_bit.insert(index_bit.end(), 2, j);
+    }
+  }
+  log << "Num variables: " << var_order.size() << " => " << numBDDVars << endl;
+
+  if ((int)var_order.size() < num_fd_vars) {
+    int num_task_bdd_vars = 0;
+    for (int var = 0; var < num_fd_vars; ++var) {
+      num_task_bdd_vars +=
+          ceil(log2(tasks::g_root_task->get_variable_domain_size(var)));
     }
+    double share = max(numBDDVars, 1) / (double)max(num_task_bdd_vars, 1);
+    cudd_init_nodes = max<long>(cudd_init_nodes * share, 1);
+    cudd_init_cache_size = max<long>(cudd_init_cache_size * share, 1);
   }
-  cout << "Num variables: " << var_order.size() << " => " << numBDDVars << endl;
 
   // Initialize manager
-  cout << "Initialize Symbolic Manager(" << _numBDDVars << ", "
-       << cudd_init_nodes / _numBDDVars << ", " << cudd_init_cache_size << ", "
-       << cudd_init_available_memory << ")" << endl;
+  log << "Initialize Symbolic Manager(" << _numBDDVars << ", "
+      << cudd_init_nodes / _numBDDVars << ", " << cudd_init_cache_size << ", "
+      << cudd_init_available_memory << ")" << endl;
   manager = unique_ptr<Cudd>(
       new Cudd(_numBDDVars, 0, cudd_init_nodes / _numBDDVars,
                cudd_init_cache_size, cudd_init_available_memory));
@@ -85,8 +227,28 @@ void SymVariables::init(const vector<int> &v_order) {
   manager->setHandler(exceptionError);
   manager->setTimeoutHandler(exceptionError);
   manager->setNodesExceededHandler(exceptionError);
+  if (cudd_max_cache_hard > 0) {
+    manager->SetMaxCacheHard(cudd_max_cache_hard);
+  }
+  if (cudd_loose_up_to > 0) {
+    manager->SetLooseUpTo(cudd_loose_up_to);
+  }
+  if (cudd_reordering != ReorderingMethod::NONE) {
+    // Each variable stays right above its primed copy, so that swapping
+    // pre and eff variables in the image remains cheap.
+    for (int var : var_order) {
+      for (int bdd_var : bdd_index_pre[var]) {
+        manager->MakeTreeNode(bdd_var, 2, MTR_FIXED);
+      }
+    }
+    if (cudd_reordering_threshold > 0) {
+      manager->SetNextReordering(cudd_reordering_threshold);
+    }
+    manager->AutodynEnable(get_cudd_reordering_type(cudd_reordering));
+  }
+  print_options(log);
 
-  cout << "Generating binary variables" << endl;
+  log << "Generating binary variables" << endl;
   // Generate binary_variables
   for (int i = 0; i < _numBDDVars; i++) {
     variables.push_back(manager->bddVar(i));
@@ -97,8 +259,18 @@ void SymVariables::init(const vector<int> &v_order) {
   biimpBDDs.resize(num_fd_vars);
   validValues.resize(num_fd_vars);
   validBDD = oneBDD();
+  // Variables outside of the order are abstracted away.
+  for (int var = 0; var < num_fd_vars; ++var) {
+    int domain_size = tasks::g_root_task->get_variable_domain_size(var);
+    preconditionBDDs[var].assign(domain_size, oneBDD());
+    effectBDDs[var].assign(domain_size, oneBDD());
+    biimpBDDs[var] = oneBDD();
+    validValues[var] = oneBDD();
+  }
   // Generate predicate (precondition (s) and effect (s')) BDDs
   for (int var : var_order) {
+    preconditionBDDs[var].clear();
+    effectBDDs[var].clear();
     for (int j = 0; j < tasks::g_root_task->get_variable_domain_size(var);
          j++) {
       preconditionBDDs[var].push_back(createPreconditionBDD(var, j));
@@ -116,15 +288,14 @@ void SymVariables::init(const vector<int> &v_order) {
 
   binState.resize(_numBDDVars, 0);
 
-  cout << "Symbolic Variables... Done." << endl;
+  log << "Symbolic Variables... Done." << endl;
 
-  ax_comp = std::shared_ptr<SymAxiomCompilation>(
-      new SymAxiomCompilation(std::shared_ptr<SymVariables>(this)));
+  ax_comp = std::make_shared<SymAxiomCompilation>(this);
   if (task_properties::has_axioms(TaskProxy(*tasks::g_root_task))) {
-    std::cout << "Creating Primary Representation for Derived Predicates..."
-              << std::endl;
+    log << "Creating Primary Representation for Derived Predicates..."
+        << endl;
     ax_comp->init_axioms();
-    std::cout << "Primary Representation... Done!" << std::endl;
+    log << "Primary Representation... Done!" << endl;
   }
 }
 
@@ -224,16 +395,70 @@ std::vector<std::string> SymVariables::get_fd_variable_names() const {
   return var_names;
 }
 
-void SymVariables::print_options() const {
-  cout << "CUDD Init: nodes=" << cudd_init_nodes
-       << " cache=" << cudd_init_cache_size
-       << " max_memory=" << cudd_init_available_memory
-       << " ordering: " << (gamer_ordering ? "gamer" : "fd") << endl;
+void SymVariables::print_options(ostream &log) const {
+  if (init_sizes_reduced) {
+    log << "CUDD initial sizes reduced to fit into the available memory"
+        << endl;
+  }
+  log << "CUDD Init: nodes=" << cudd_init_nodes
+      << " cache=" << cudd_init_cache_size
+      << " max_memory=" << cudd_init_available_memory
+      << " max_cache_hard=" << cudd_max_cache_hard
+      << " loose_up_to=" << cudd_loose_up_to
+      << " reordering=" << cudd_reordering
+      << " reordering_threshold=" << cudd_reordering_threshold
+      << " ordering: " << (gamer_ordering ? "gamer" : "fd") << endl;
 }
 
 void SymVariables::add_options_to_parser(options::OptionParser &parser) {
   parser.add_option<bool>("gamer_ordering", "Use Gamer ordering optimization",
                           "true");
+  parser.add_option<int>("cudd_init_nodes",
+                         "initial number of nodes in the CUDD unique table "
+                         "(default: 16000000, reduced to fit into the memory "
+                         "of the manager)",
+                         options::OptionParser::NONE,
+                         options::Bounds("1", "infinity"));
+  parser.add_option<int>("cudd_init_cache_size",
+                         "initial number of entries in the CUDD cache "
+                         "(default: 16000000, reduced to fit into the memory "
+                         "of the manager)",
+                         options::OptionParser::NONE,
+                         options::Bounds("1", "infinity"));
+  parser.add_option<int>(
+      "cudd_max_memory",
+      "maximum memory (MB) of the CUDD manager. 0 uses three quarters of the "
+      "memory limit of the process if there is one and lets CUDD decide "
+      "otherwise. Initial sizes that are not set explicitly are reduced to "
+      "fit into half of it.",
+      "0", options::Bounds("0", "infinity"));
+  parser.add_option<int>("cudd_max_cache_hard",
+                         "hard limit for the CUDD cache size (0: CUDD default)",
+                         "0", options::Bounds("0", "infinity"));
+  parser.add_option<int>(
+      "cudd_loose_up_to",
+      "number of nodes up to which the CUDD unique table grows without "
+      "garbage collection (0: CUDD default)",
+      "0", options::Bounds("0", "infinity"));
+  parser.add_enum_option("cudd_reordering", ReorderingMethodValues,
+                         "dynamic variable reordering method of CUDD. Each "
+                         "variable is kept next to its primed copy.",
+                         "NONE");
+  parser.add_option<int>(
+      "cudd_reordering_threshold",
+      "number of nodes that triggers the first dynamic reordering; later "
+      "reorderings happen when the number of nodes has doubled since the "
+      "last one (0: CUDD default)",
+      "0", options::Bounds("0", "infinity"));
+}
+
+void SymVariables::print_statistics() const {
+  if (!manager || cudd_reordering == ReorderingMethod::NONE) {
+    return;
+  }
+  cout << "CUDD reorderings: " << manager->ReadReorderings()
+       << ", reordering time: " << manager->ReadReorderingTime() / 1000.0
+       << "s" << endl;
 }
 
 void SymVariables::bdd_to_dot(const BDD &bdd, const std::string &file_name) const {
@@ -2,18 +2,21 @@
 #define SYMBOLIC_SYM_VARIABLES_H
 
 #include "sym_bucket.h"
+#include "sym_enums.h"
 
 #include "../state_registry.h"
 #include "../tasks/root_task.h"
 #include "../utils/timer.h"
 #include "sym_axiom/sym_axiom_compilation.h"
 
+#include <algorithm>
 #include <cassert>
 #include <fstream>
 #include <iostream>
 #include <map>
 #include <math.h>
 #include <memory>
+#include <numeric>
 #include <set>
 #include <sstream>
 #include <string>
@@ -41,10 +44,23 @@ class SymVariables {
   // Var order used by the algorithm.
   // const VariableOrderType variable_ordering;
   // Parameters to initialize the CUDD manager
-  const long cudd_init_nodes;            // Number of initial nodes
-  const long cudd_init_cache_size;       // Initial cache size
-  const long cudd_init_available_memory; // Maximum available memory (bytes)
+  long cudd_init_nodes;            // Number of initial nodes
+  long cudd_init_cache_size;       // Initial cache size
+  long cudd_init_available_memory; // Maximum available memory (bytes)
+  long cudd_max_cache_hard;        // Hard limit for the cache (0: default)
+  long cudd_loose_up_to;           // Unique table growth limit (0: default)
+  const ReorderingMethod cudd_reordering; // Dynamic reordering method
+  int cudd_reordering_threshold; // Nodes that trigger the first reordering
   const bool gamer_ordering;
+  // Initial sizes that were not set explicitly and may be reduced
+  bool auto_init_nodes;
+  bool auto_init_cache_size;
+  // True if fit_to_available_memory reduced the initial sizes
+  bool init_sizes_reduced;
+
+  // Reduces the initial sizes that were not set explicitly so that they fit
+  // into the available memory
+  void fit_to_available_memory();
 
   std::unique_ptr<Cudd> manager; // manager associated with this symbolic search
   std::shared_ptr<SymAxiomCompilation> ax_comp;  // used for axioms
@@ -58,6 +74,8 @@ class SymVariables {
   std::vector<int> var_order; // Variable(FD) order in the BDD
   std::vector<std::vector<int>> bdd_index_pre, bdd_index_eff,
       bdd_index_abs; // vars(BDD) for each var(FD)
+  // var(FD) and bit position encoded by each var(BDD), used for ADD descent
+  std::vector<int> index_var, index_bit;
 
   std::vector<std::vector<BDD>>
       preconditionBDDs; // BDDs associated with the precondition of a predicate
@@ -73,12 +91,34 @@ class SymVariables {
   // Avoid allocating memory during heuristic evaluation
   std::vector<int> binState;
 
-  void init(const std::vector<int> &v_order);
-
 public:
   SymVariables(const options::Options &opts);
   SymVariables(bool gamer_ordering);
   void init();
+  /*
+   * Creates BDD variables only for the FD variables in v_order. All other
+   * variables are abstracted away: their precondition and effect BDDs are
+   * true. The initial sizes of the unique table and the cache are reduced
+   * in proportion to the share of binary variables that are created.
+   * Progress is written to log.
+   */
+  void init(const std::vector<int> &v_order, std::ostream &log = std::cout);
+
+  // Variable order that init() uses (gamer ordering or the FD order).
+  std::vector<int> compute_var_order() const;
+
+  const std::vector<int> &get_var_order() const { return var_order; }
+
+  // Variable order for a manager with only the given FD variables: the
+  // gamer ordering restricted to them or their FD order.
+  std::vector<int> compute_var_order(const std::vector<int> &vars) const;
+
+  // Divides the memory of the manager among num_managers managers that
+  // are used at the same time. Must be called before init().
+  void split_memory(int num_managers);
+
+  // Prints the number of dynamic reorderings and the time spent in them.
+  void print_statistics() const;
 
   std::shared_ptr<StateRegistry> get_state_registry() {
     if (state_registry == nullptr) {
@@ -112,6 +152,10 @@ public:
     return bdd_index_abs[variable];
   }
 
+  inline int index_to_var(int index) const { return index_var[index]; }
+
+  inline int index_to_bit(int index) const { return index_bit[index]; }
+
   inline const BDD &preBDD(int variable, int value) const {
     return preconditionBDDs[variable][value];
   }
@@ -174,6 +218,11 @@ public:
     ;
   }
 
+  // Number of states in a BDD over the pre variables
+  inline double numStates(const BDD &bdd) const {
+    return bdd.CountMinterm(numBDDVars);
+  }
+
   inline BDD validStates() const { return validBDD; }
 
   inline BDD bddVar(int index) const { return variables[index]; }
@@ -207,12 +256,75 @@ public:
     return &(binState[0]);
   }
 
+  /*
+   * Evaluates an ADD on a state by descending from the root to a terminal,
+   * choosing the child given by the state's value of the bit encoded by each
+   * node, as in getBinaryDescription. No nodes are created and the computed
+   * table is not touched, so the cost is linear in the depth of the ADD.
+   */
+  template <class T> double getADDValue(const ADD &add, const T &state) const {
+    DdNode *node = add.getNode();
+    while (!Cudd_IsConstant(node)) {
+      int index = Cudd_NodeReadIndex(node);
+      if ((state[index_var[index]] >> index_bit[index]) % 2) {
+        node = Cudd_T(node);
+      } else {
+        node = Cudd_E(node);
+      }
+    }
+    return Cudd_V(node);
+  }
+
+  /*
+   * Evaluates an ADD on num_states states at once, where state_value(i, var)
+   * is the value of var in state i. The states that take the same branch at
+   * a node descend together, so the nodes on a shared prefix of their paths
+   * are only visited once.
+   */
+  template <class StateValue>
+  void getADDValues(const ADD &add, int num_states,
+                    const StateValue &state_value,
+                    std::vector<double> &values) const {
+    struct Group {
+      DdNode *node;
+      int begin, end; // Range of the states of the group in order
+    };
+    values.resize(num_states);
+    std::vector<int> order(num_states);
+    std::iota(order.begin(), order.end(), 0);
+    std::vector<Group> open{{add.getNode(), 0, num_states}};
+    while (!open.empty()) {
+      Group group = open.back();
+      open.pop_back();
+      if (group.begin == group.end) {
+        continue;
+      }
+      if (Cudd_IsConstant(group.node)) {
+        for (int k = group.begin; k < group.end; ++k) {
+          values[order[k]] = Cudd_V(group.node);
+        }
+        continue;
+      }
+      int index = Cudd_NodeReadIndex(group.node);
+      int var = index_var[index];
+      int bit = index_bit[index];
+      int mid = std::partition(order.begin() + group.begin,
+                               order.begin() + group.end,
+                               [&](int i) {
+                                 return (state_value(i, var) >> bit) % 2 == 0;
+                               }) -
+                order.begin();
+      open.push_back({Cudd_E(group.node), group.begin, mid});
+      open.push_back({Cudd_T(group.node), mid, group.end});
+    }
+  }
+
   std::vector<std::string> get_fd_variable_names() const;
 
   static void add_options_to_parser(options::OptionParser &parser);
 
-  void print_options() const;
-  
+  void print_options(std::ostream &log = std::cout) const;
+
   void bdd_to_dot(const BDD &bdd, const std::string &file_name) const;
 
 private:
@@ -238,6 +350,15 @@ private:
 
   inline int getNumBDDVars() const { return numBDDVars; }
 };
+
+/*
+ * Returns the SymVariables shared by all users of the root task, creating
+ * and initializing it with the given options if no user holds it yet. All
+ * users share the CUDD manager (unique table and computed cache), which is
+ * released together with the last reference.
+ */
+extern std::shared_ptr<SymVariables>
+get_shared_sym_variables(const options::Options &opts);
 } // namespace symbolic
 
 #endif
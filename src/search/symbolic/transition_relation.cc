@@ -15,11 +15,35 @@ namespace symbolic {
 TransitionRelation::TransitionRelation(SymVariables *sVars, OperatorID op_id,
                                        int cost_)
     : sV(sVars), cost(cost_), tBDD(sVars->oneBDD()),
-      existsVars(sVars->oneBDD()), existsBwVars(sVars->oneBDD()) {
+      existsVars(sVars->oneBDD()), existsBwVars(sVars->oneBDD()),
+      notMutexPre(sVars->oneBDD()), notMutexEff(sVars->oneBDD()) {
   ops_ids.insert(op_id);
 }
 
-void TransitionRelation::init() {
+TransitionRelation::TransitionRelation(SymVariables *sVars,
+                                       const TransitionRelation &other)
+    : sV(sVars), cost(other.cost),
+      tBDD(other.tBDD.Transfer(*sVars->get_manager())),
+      effVars(other.effVars),
+      existsVars(other.existsVars.Transfer(*sVars->get_manager())),
+      existsBwVars(other.existsBwVars.Transfer(*sVars->get_manager())),
+      ops_ids(other.ops_ids),
+      notMutexPre(other.notMutexPre.Transfer(*sVars->get_manager())),
+      notMutexEff(other.notMutexEff.Transfer(*sVars->get_manager())) {
+  for (const BDD &var : other.swapVarsS) {
+    swapVarsS.push_back(var.Transfer(*sVars->get_manager()));
+  }
+  for (const BDD &var : other.swapVarsSp) {
+    swapVarsSp.push_back(var.Transfer(*sVars->get_manager()));
+  }
+  for (size_t i = 0; i < other.conjuncts.size(); ++i) {
+    conjuncts.push_back(other.conjuncts[i].Transfer(*sVars->get_manager()));
+    existsFw.push_back(other.existsFw[i].Transfer(*sVars->get_manager()));
+    existsBw.push_back(other.existsBw[i].Transfer(*sVars->get_manager()));
+  }
+}
+
+void TransitionRelation::init(bool partitioned) {
   TaskProxy task_proxy(*tasks::g_root_task);
   OperatorProxy op = task_proxy.get_operators()[ops_ids.begin()->get_index()];
 
@@ -72,9 +96,17 @@ void TransitionRelation::init() {
     if (!effect_conditions[var].IsZero()) {
       effectBDD += (effect_conditions[var] * sV->biimp(var));
     }
-    tBDD *= effectBDD;
+    if (partitioned) {
+      conjuncts.push_back(effectBDD);
+    } else {
+      tBDD *= effectBDD;
+    }
     counter++;
   }
+  if (partitioned) {
+    // tBDD only contains the preconditions
+    conjuncts.insert(conjuncts.begin(), tBDD);
+  }
   if (tBDD.IsZero()) {
     cerr << "Operator is empty: " << op.get_name() << endl;
     // exit(0);
@@ -95,9 +127,53 @@ void TransitionRelation::init() {
     existsVars *= swapVarsS[i];
     existsBwVars *= swapVarsSp[i];
   }
+  if (partitioned) {
+    compute_quantification_schedule();
+  }
+}
+
+void TransitionRelation::compute_quantification_schedule() {
+  existsFw.assign(conjuncts.size(), sV->oneBDD());
+  existsBw.assign(conjuncts.size(), sV->oneBDD());
+  BDD remainingFw = existsVars, remainingBw = existsBwVars;
+  for (int i = conjuncts.size() - 1; i > 0; --i) {
+    BDD support = conjuncts[i].Support();
+    existsFw[i] = support.LiteralSetIntersection(remainingFw);
+    existsBw[i] = support.LiteralSetIntersection(remainingBw);
+    remainingFw = remainingFw.ExistAbstract(existsFw[i]);
+    remainingBw = remainingBw.ExistAbstract(existsBw[i]);
+  }
+  // Variables in no conjunct only appear in the states of the image
+  existsFw[0] = remainingFw;
+  existsBw[0] = remainingBw;
+}
+
+BDD TransitionRelation::partitioned_image(const BDD &from, bool fw,
+                                          int maxNodes) const {
+  const vector<BDD> &exists = fw ? existsFw : existsBw;
+  BDD res = from.And(fw ? notMutexPre : notMutexEff, maxNodes);
+  for (size_t i = 0; i < conjuncts.size(); ++i) {
+    res = conjuncts[i].AndAbstract(res, exists[i], maxNodes);
+  }
+  return res.And(fw ? notMutexEff : notMutexPre, maxNodes);
+}
+
+int TransitionRelation::nodeCount() const {
+  if (!is_partitioned()) {
+    return tBDD.nodeCount();
+  }
+  int nodes = 0;
+  for (const BDD &conjunct : conjuncts) {
+    nodes += conjunct.nodeCount();
+  }
+  return nodes + notMutexPre.nodeCount() + notMutexEff.nodeCount();
 }
 
 BDD TransitionRelation::image(const BDD &from) const {
+  if (is_partitioned()) {
+    return partitioned_image(from, true, 0)
+        .SwapVariables(swapVarsS, swapVarsSp);
+  }
   BDD aux = from;
   BDD tmp = tBDD.AndAbstract(aux, existsVars);
   BDD res = tmp.SwapVariables(swapVarsS, swapVarsSp);
@@ -105,6 +181,10 @@ BDD TransitionRelation::image(const BDD &from) const {
 }
 
 BDD TransitionRelation::image(const BDD &from, int maxNodes) const {
+  if (is_partitioned()) {
+    return partitioned_image(from, true, maxNodes)
+        .SwapVariables(swapVarsS, swapVarsSp);
+  }
   utils::Timer t;
   BDD aux = from;
   BDD tmp = tBDD.AndAbstract(aux, existsVars, maxNodes);
@@ -114,6 +194,9 @@ BDD TransitionRelation::image(const BDD &from, int maxNodes) const {
 
 BDD TransitionRelation::preimage(const BDD &from) const {
   BDD tmp = from.SwapVariables(swapVarsS, swapVarsSp);
+  if (is_partitioned()) {
+    return partitioned_image(tmp, false, 0);
+  }
   BDD res = tBDD.AndAbstract(tmp, existsBwVars);
   return res;
 }
@@ -121,11 +204,16 @@ BDD TransitionRelation::preimage(const BDD &from) const {
 BDD TransitionRelation::preimage(const BDD &from, int maxNodes) const {
   utils::Timer t;
   BDD tmp = from.SwapVariables(swapVarsS, swapVarsSp);
+  if (is_partitioned()) {
+    return partitioned_image(tmp, false, maxNodes);
+  }
   BDD res = tBDD.AndAbstract(tmp, existsBwVars, maxNodes);
   return res;
 }
 
 void TransitionRelation::merge(const TransitionRelation &t2, int maxNodes) {
+  // Partitioned TRs are kept separate
+  assert(!is_partitioned() && !t2.is_partitioned());
   assert(cost == t2.cost);
   if (cost != t2.cost) {
     cout << "Error: merging transitions with different cost: " << cost << " "
@@ -182,6 +270,51 @@ void TransitionRelation::merge(const TransitionRelation &t2, int maxNodes) {
   ops_ids.insert(t2.ops_ids.begin(), t2.ops_ids.end());
 }
 
+ADD TransitionRelation::image(const ADD &from) const {
+  ADD res = from;
+  if (is_partitioned()) {
+    res *= notMutexPre.Add();
+    for (size_t i = 0; i < conjuncts.size(); ++i) {
+      res = (res * conjuncts[i].Add()).ExistAbstract(existsFw[i].Add());
+    }
+    res *= notMutexEff.Add();
+  } else {
+    res = (res * tBDD.Add()).ExistAbstract(existsVars.Add());
+  }
+  vector<ADD> swapAddsS, swapAddsSp;
+  for (size_t i = 0; i < swapVarsS.size(); ++i) {
+    swapAddsS.push_back(swapVarsS[i].Add());
+    swapAddsSp.push_back(swapVarsSp[i].Add());
+  }
+  return res.SwapVariables(swapAddsS, swapAddsSp);
+}
+
+void TransitionRelation::abstract(const set<int> &abstracted_vars) {
+  assert(!is_partitioned());
+  tBDD = tBDD.ExistAbstract(sV->getCubePre(abstracted_vars) *
+                            sV->getCubeEff(abstracted_vars));
+
+  vector<int> newEffVars;
+  set_difference(effVars.begin(), effVars.end(), abstracted_vars.begin(),
+                 abstracted_vars.end(), back_inserter(newEffVars));
+  effVars.swap(newEffVars);
+
+  swapVarsS.clear();
+  swapVarsSp.clear();
+  existsVars = sV->oneBDD();
+  existsBwVars = sV->oneBDD();
+  for (int var : effVars) {
+    for (int bdd_var : sV->vars_index_pre(var)) {
+      swapVarsS.push_back(sV->bddVar(bdd_var));
+      existsVars *= sV->bddVar(bdd_var);
+    }
+    for (int bdd_var : sV->vars_index_eff(var)) {
+      swapVarsSp.push_back(sV->bddVar(bdd_var));
+      existsBwVars *= sV->bddVar(bdd_var);
+    }
+  }
+}
+
 // For each op, include relevant mutexes
 
 void TransitionRelation::edeletion(
@@ -196,6 +329,9 @@ void TransitionRelation::edeletion(
   assert(exactlyOneBDDsByFluent.size() ==
          tasks::g_root_task->get_num_variables());
   TaskProxy task_proxy(*tasks::g_root_task);
+  // Partitioned TRs keep the mutexes apart from the conjuncts
+  BDD &resBw = is_partitioned() ? notMutexPre : tBDD;
+  BDD &resFw = is_partitioned() ? notMutexEff : tBDD;
   // For each op, include relevant mutexes
   for (const OperatorID &op_id : ops_ids) {
     OperatorProxy op = task_proxy.get_operators()[op_id.get_index()];
@@ -218,20 +354,20 @@ void TransitionRelation::edeletion(
         for (int val = 0;
              val < tasks::g_root_task->get_variable_domain_size(pp.var);
              val++) {
-          tBDD *= notMutexBDDsByFluentBw[pp.var][val];
+          resBw *= notMutexBDDsByFluentBw[pp.var][val];
         }
       } else {
         // In regression, we are making true pp.pre
         // So we must negate everything of these.
-        tBDD *= notMutexBDDsByFluentBw[pp.var][pre.value];
+        resBw *= notMutexBDDsByFluentBw[pp.var][pre.value];
       }
       // TODO(speckd): Here we need to swap in the correct direction!
       // edeletion fw
-      tBDD *= notMutexBDDsByFluentFw[pp.var][pp.value].SwapVariables(
+      resFw *= notMutexBDDsByFluentFw[pp.var][pp.value].SwapVariables(
           swapVarsS, swapVarsSp);
 
       // edeletion invariants
-      tBDD *= exactlyOneBDDsByFluent[pp.var][pp.value];
+      resBw *= exactlyOneBDDsByFluent[pp.var][pp.value];
     }
   }
 }
@@ -241,7 +377,7 @@ ostream &operator<<(std::ostream &os, const TransitionRelation &tr) {
   for (auto &op : tr.ops_ids) {
     os << tasks::g_root_task->get_operator_name(op.get_index(), false) << ", ";
   }
-  return os << "): " << tr.tBDD.nodeCount() << endl;
+  return os << "): " << tr.nodeCount() << endl;
 }
 
 } // namespace symbolic
@@ -5,6 +5,7 @@
 
 #include "../task_proxy.h"
 
+#include <cassert>
 #include <set>
 #include <vector>
 
@@ -32,34 +33,65 @@ class TransitionRelation {
 
   std::set<OperatorID> ops_ids; // List of operators represented by the TR
 
+  // Conjunctive partition of the TR (empty if it is represented by tBDD).
+  // existsFw[i]/existsBw[i] are the variables that do not appear in any
+  // later conjunct, which are quantified right after conjoining conjuncts[i]
+  std::vector<BDD> conjuncts;
+  std::vector<BDD> existsFw, existsBw;
+  // Mutexes of a partitioned TR on the states before and after the
+  // transition. They are conjoined with the operand and the result of the
+  // image, so they do not delay the quantification of the conjuncts.
+  BDD notMutexPre, notMutexEff;
+
+  void compute_quantification_schedule();
+  BDD partitioned_image(const BDD &from, bool fw, int maxNodes) const;
+
 public:
   // Constructor for transitions irrelevant for the abstraction
   TransitionRelation(SymVariables *sVars, OperatorID op_id, int cost_);
-  void init();
+  // If partitioned, the preconditions and the effect on each variable are
+  // kept as separate conjuncts that are never merged with other TRs
+  void init(bool partitioned = false);
 
   // Copy constructor
   TransitionRelation(const TransitionRelation &) = default;
 
+  // Copy of other in the manager of sVars, which must have the same BDD
+  // variables as the manager of other
+  TransitionRelation(SymVariables *sVars, const TransitionRelation &other);
+
   BDD image(const BDD &from) const;
   BDD preimage(const BDD &from) const;
   BDD image(const BDD &from, int maxNodes) const;
   BDD preimage(const BDD &from, int maxNodes) const;
 
+  // Image of an ADD over states, e.g., the number of paths to each state.
+  // The values of all predecessors of a state are added up
+  ADD image(const ADD &from) const;
+
   void edeletion(const std::vector<std::vector<BDD>> &notMutexBDDsByFluentFw,
                  const std::vector<std::vector<BDD>> &notMutexBDDsByFluentBw,
                  const std::vector<std::vector<BDD>> &exactlyOneBDDsByFluent);
 
   void merge(const TransitionRelation &t2, int maxNodes);
 
+  // Projects the TR onto the variables that are not in abstracted_vars
+  void abstract(const std::set<int> &abstracted_vars);
+
   int getCost() const { return cost; }
 
   void set_cost(int cost_) { cost = cost_; }
 
-  int nodeCount() const { return tBDD.nodeCount(); }
+  int nodeCount() const;
+
+  bool is_partitioned() const { return !conjuncts.empty(); }
 
   const std::set<OperatorID> &getOpsIds() const { return ops_ids; }
 
-  const BDD &getBDD() const { return tBDD; }
+  const BDD &getBDD() const {
+    assert(!is_partitioned());
+    return tBDD;
+  }
 
   friend std::ostream &operator<<(std::ostream &os,
                                   const TransitionRelation &tr);
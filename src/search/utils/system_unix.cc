@@ -33,6 +33,7 @@
 #include <limits>
 #include <new>
 #include <stdlib.h>
+#include <sys/resource.h>
 #include <unistd.h>
 
 #if OPERATING_SYSTEM == OSX
@@ -219,6 +220,13 @@ int get_peak_memory_in_kb() {
     return memory_in_kb;
 }
 
+int get_memory_limit_in_mb() {
+    rlimit limit;
+    if (getrlimit(RLIMIT_AS, &limit) != 0 || limit.rlim_cur == RLIM_INFINITY)
+        return -1;
+    return limit.rlim_cur / (1024 * 1024);
+}
+
 void register_event_handlers() {
     // Terminate when running out of memory.
     set_new_handler(out_of_memory_handler);
@@ -39,6 +39,11 @@ int get_peak_memory_in_kb() {
     return pmc.PeakPagefileUsage / 1024;
 }
 
+int get_memory_limit_in_mb() {
+    // The driver does not limit the memory on Windows.
+    return -1;
+}
+
 void register_event_handlers() {
     // Terminate when running out of memory.
     set_new_handler(out_of_memory_handler);